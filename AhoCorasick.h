@@ -0,0 +1,228 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Multi-pattern matcher compiled once from a list of byte patterns.
+// Bytes that appear in no pattern share one class, so the automaton is a
+// dense table of stateCount * classCount transitions with failure links
+// already folded in: every input byte costs one table load no matter how many
+// patterns there are. A compiled automaton is read-only and can be shared
+// between threads.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "String.h"
+#include "StringBuilder.h"
+
+typedef struct AhoCorasick
+{
+    uint32_t* next;      // stateCount * classCount transitions
+    int32_t* pattern;    // pattern ending exactly at state, -1 if none
+    uint32_t* outLink;   // nearest suffix state with a pattern, 0 if none
+    uint32_t* depth;     // length of the prefix a state stands for
+    uint32_t* patternLens;
+    uint32_t stateCount;
+    uint32_t classCount;
+    uint32_t patternCount;
+    uint8_t byteClass[256];
+} AhoCorasick;
+
+// callback returns 0 to stop; match covers text[start, end)
+typedef int (*AhoCorasickCallback)(uint32_t pattern, uint32_t start, uint32_t end, void* userData);
+
+void AhoCorasickFree(AhoCorasick* ac)
+{
+    free(ac->next);
+    free(ac->pattern);
+    free(ac->outLink);
+    free(ac->depth);
+    free(ac->patternLens);
+    ac->next = NULL;
+    ac->pattern = NULL;
+    ac->outLink = NULL;
+    ac->depth = NULL;
+    ac->patternLens = NULL;
+    ac->stateCount = 0;
+    ac->patternCount = 0;
+}
+
+// lens may be NULL for NUL terminated patterns; empty patterns never match
+int AhoCorasickInit(AhoCorasick* ac, const char* const* patterns, const uint32_t* lens, uint32_t count)
+{
+    memset(ac, 0, sizeof(AhoCorasick));
+    ac->patternCount = count;
+    ac->patternLens = (uint32_t*)malloc(sizeof(uint32_t) * (count ? count : 1));
+    if (ac->patternLens == NULL) return 0;
+
+    // byte classes; class 0 = bytes in no pattern
+    uint64_t maxStates = 1;
+    for (uint32_t p=0; p<count; p++) {
+        uint32_t len = lens ? lens[p] : (uint32_t)strlen(patterns[p]);
+        ac->patternLens[p] = len;
+        maxStates += len;
+        for (uint32_t k=0; k<len; k++) ac->byteClass[(uint8_t)patterns[p][k]] = 1;
+    }
+    ac->classCount = 1;
+    for (int b=0; b<256; b++) {
+        if (ac->byteClass[b]) ac->byteClass[b] = (uint8_t)ac->classCount++;
+    }
+    if (maxStates * ac->classCount > 0xFFFFFFFFu) {
+        AhoCorasickFree(ac);
+        return 0;
+    }
+
+    uint32_t classCount = ac->classCount;
+    ac->next = (uint32_t*)calloc((size_t)maxStates * classCount, sizeof(uint32_t));
+    ac->pattern = (int32_t*)malloc(sizeof(int32_t) * maxStates);
+    ac->outLink = (uint32_t*)calloc(maxStates, sizeof(uint32_t));
+    ac->depth = (uint32_t*)calloc(maxStates, sizeof(uint32_t));
+    uint32_t* fail = (uint32_t*)calloc(maxStates, sizeof(uint32_t));
+    uint32_t* queue = (uint32_t*)malloc(sizeof(uint32_t) * maxStates);
+    if (ac->next == NULL || ac->pattern == NULL || ac->outLink == NULL || ac->depth == NULL || fail == NULL || queue == NULL) {
+        free(fail);
+        free(queue);
+        AhoCorasickFree(ac);
+        return 0;
+    }
+    for (uint64_t s=0; s<maxStates; s++) ac->pattern[s] = -1;
+
+    // trie, 0 = no edge while building
+    ac->stateCount = 1;
+    for (uint32_t p=0; p<count; p++) {
+        if (ac->patternLens[p] == 0) continue;
+        uint32_t state = 0;
+        for (uint32_t k=0; k<ac->patternLens[p]; k++) {
+            uint32_t* edge = &ac->next[(size_t)state * classCount + ac->byteClass[(uint8_t)patterns[p][k]]];
+            if (*edge == 0) {
+                *edge = ac->stateCount++;
+                ac->depth[*edge] = k + 1;
+            }
+            state = *edge;
+        }
+        if (ac->pattern[state] < 0) ac->pattern[state] = (int32_t)p; // first of duplicates wins
+    }
+
+    // breadth first: failure links, then fold them into missing edges
+    uint32_t head = 0, tail = 0;
+    for (uint32_t c=0; c<classCount; c++) {
+        uint32_t child = ac->next[c];
+        if (child) queue[tail++] = child;
+    }
+    while (head < tail) {
+        uint32_t state = queue[head++];
+        uint32_t* row = &ac->next[(size_t)state * classCount];
+        const uint32_t* failRow = &ac->next[(size_t)fail[state] * classCount];
+        for (uint32_t c=0; c<classCount; c++) {
+            uint32_t child = row[c];
+            if (child == 0) {
+                row[c] = failRow[c];
+                continue;
+            }
+            fail[child] = failRow[c];
+            ac->outLink[child] = ac->pattern[fail[child]] >= 0 ? fail[child] : ac->outLink[fail[child]];
+            queue[tail++] = child;
+        }
+    }
+
+    free(fail);
+    free(queue);
+    return 1;
+}
+
+// reports every match, overlapping ones included, in order of end position
+void AhoCorasickFindAllN(const AhoCorasick* ac, const char* text, uint32_t len, AhoCorasickCallback fn, void* userData)
+{
+    uint32_t state = 0;
+    for (uint32_t i=0; i<len; i++) {
+        state = ac->next[(size_t)state * ac->classCount + ac->byteClass[(uint8_t)text[i]]];
+        uint32_t out = ac->pattern[state] >= 0 ? state : ac->outLink[state];
+        while (out) {
+            uint32_t p = (uint32_t)ac->pattern[out];
+            if (!fn(p, i + 1 - ac->patternLens[p], i + 1, userData)) return;
+            out = ac->outLink[out];
+        }
+    }
+}
+
+void AhoCorasickFindAll(const AhoCorasick* ac, String text, AhoCorasickCallback fn, void* userData)
+{
+    AhoCorasickFindAllN(ac, StringCstr(text), StringLen(text), fn, userData);
+}
+
+// Replaces matches with replacements[pattern] in one pass, leftmost-longest:
+// the match that starts first wins, the longest one if several start at the
+// same byte, and matching restarts after it so replaced text never overlaps.
+// e.g. {"abcd", "bc"} replace "zabcdz" as "z" + r[0] + "z".
+// replacementLens may be NULL for NUL terminated replacements.
+String AhoCorasickReplaceAllN(const AhoCorasick* ac, const char* text, uint32_t len, const char* const* replacements, const uint32_t* replacementLens)
+{
+    StringBuilder builder;
+    if (!StringBuilderInit(&builder, len)) return NULL;
+
+    uint32_t state = 0;
+    uint32_t copyFrom = 0;
+    int32_t match = -1; // best match so far covers text[matchStart, matchEnd)
+    uint32_t matchStart = 0;
+    uint32_t matchEnd = 0;
+    uint32_t i = 0;
+    while (i < len) {
+        state = ac->next[(size_t)state * ac->classCount + ac->byteClass[(uint8_t)text[i]]];
+        i++;
+
+        // deepest state first = longest pattern ending here = earliest start
+        uint32_t out = ac->pattern[state] >= 0 ? state : ac->outLink[state];
+        if (out) {
+            uint32_t p = (uint32_t)ac->pattern[out];
+            uint32_t start = i - ac->patternLens[p];
+            if (match < 0 || start <= matchStart) {
+                match = (int32_t)p;
+                matchStart = start;
+                matchEnd = i;
+            }
+        }
+
+        // commit once no match starting at or before matchStart can still
+        // complete: the current state only remembers the last depth bytes
+        if (match >= 0 && (i - ac->depth[state] > matchStart || i == len)) {
+            uint32_t replacementLen = replacementLens ? replacementLens[match] : (uint32_t)strlen(replacements[match]);
+            if (!StringBuilderAppendN(&builder, text + copyFrom, matchStart - copyFrom)
+                || !StringBuilderAppendN(&builder, replacements[match], replacementLen)) {
+                StringBuilderFree(&builder);
+                return NULL;
+            }
+            copyFrom = matchEnd;
+            i = matchEnd; // bytes scanned past the match are matched again
+            state = 0;
+            match = -1;
+        }
+    }
+    if (!StringBuilderAppendN(&builder, text + copyFrom, len - copyFrom)) {
+        StringBuilderFree(&builder);
+        return NULL;
+    }
+    return StringBuilderFinalize(&builder);
+}
+
+String AhoCorasickReplaceAll(const AhoCorasick* ac, String text, const char* const* replacements, const uint32_t* replacementLens)
+{
+    return AhoCorasickReplaceAllN(ac, StringCstr(text), StringLen(text), replacements, replacementLens);
+}
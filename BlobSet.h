@@ -0,0 +1,379 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Set of variable length byte blobs (may contain NUL bytes).
+// Blob bytes are copied into large arena chunks like LinearStringmap keys.
+// Each slot keeps the blob's hash and length so most mismatches are rejected
+// without touching the arena, and growing never re-hashes.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct BlobSetChunk
+{
+    char* buffer;
+    uint32_t capacity;
+    uint32_t used;
+} BlobSetChunk;
+
+typedef struct BlobSetSlot
+{
+    char* data;
+    uint32_t len;
+    uint32_t hash;
+} BlobSetSlot;
+
+typedef struct BlobSet
+{
+    // chunk array
+    BlobSetChunk* chunkArray;
+    uint32_t chunkArraySize;
+    uint32_t chunkArrayCapacity;
+    uint32_t allocSearchStart;
+    uint32_t totalChunkCapacity;
+
+    // hash set
+    uint8_t* occupancy;
+    BlobSetSlot* slots;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t maxProbes;
+} BlobSet;
+
+typedef struct BlobSetIterator
+{
+    BlobSet* set;
+    uint32_t index;
+} BlobSetIterator;
+
+void BlobSetFree(BlobSet* set)
+{
+    if (!set) return;
+    if (set->chunkArray) {
+        for (uint32_t i=0; i<set->chunkArraySize; i++) free(set->chunkArray[i].buffer);
+        free(set->chunkArray);
+    }
+    if (set->occupancy) free(set->occupancy);
+    if (set->slots) free(set->slots);
+    set->chunkArray = NULL;
+    set->occupancy = NULL;
+    set->slots = NULL;
+    set->chunkArraySize = 0;
+    set->chunkArrayCapacity = 0;
+    set->allocSearchStart = 0;
+    set->totalChunkCapacity = 0;
+    set->capacity = 0;
+    set->count = 0;
+    set->maxProbes = 0;
+}
+
+int BlobSetInit(BlobSet* set, uint32_t capacity, uint32_t chunkCapacity)
+{
+    // create chunk buffer array
+    if (chunkCapacity < 512) chunkCapacity = 512;
+    if (capacity < 16) capacity = 16;
+    set->chunkArrayCapacity = 8;
+    set->chunkArray = (BlobSetChunk*)malloc(sizeof(BlobSetChunk) * set->chunkArrayCapacity);
+    set->occupancy = NULL;
+    set->slots = NULL;
+    if (set->chunkArray == NULL) return 0;
+    set->chunkArraySize = 1;
+    set->allocSearchStart = 0;
+    set->totalChunkCapacity = chunkCapacity;
+
+    // create first chunk
+    set->chunkArray[0].buffer = (char*)malloc(chunkCapacity);
+    if (set->chunkArray[0].buffer == NULL) {
+        BlobSetFree(set); return 0;
+    }
+    set->chunkArray[0].capacity = chunkCapacity;
+    set->chunkArray[0].used = 0;
+
+    // create hash set
+    set->capacity = capacity;
+    set->occupancy = (uint8_t*)calloc((capacity + 7) >> 3, 1);
+    set->slots = (BlobSetSlot*)malloc(sizeof(BlobSetSlot) * capacity);
+    if (set->occupancy == NULL || set->slots == NULL) {
+        BlobSetFree(set); return 0;
+    }
+    set->count = 0;
+    set->maxProbes = 1;
+    return 1;
+}
+
+// FNV algorithm https://github.com/aappleby/smhasher/blob/master/src/Hashes.cpp
+uint32_t BlobSetHash(const void* data, uint32_t len)
+{
+    uint32_t hash = 2166136261u;
+    const uint8_t* p = (const uint8_t*)data;
+    for (uint32_t i=0; i<len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static inline uint8_t BlobSetSlotPresent(BlobSet* set, uint32_t i)
+{
+    return set->occupancy[i >> 3] & (1u << (i & 7));
+}
+
+static inline void BlobSetMarkSlot(BlobSet* set, uint32_t i)
+{
+    set->occupancy[i >> 3] |= (uint8_t)(1 << (i & 7));
+}
+
+static inline void BlobSetClearSlot(BlobSet* set, uint32_t i)
+{
+    set->occupancy[i >> 3] &= ~(1u << (i & 7));
+}
+
+static inline int BlobSetSlotMatches(BlobSetSlot* slot, const void* data, uint32_t len, uint32_t hash)
+{
+    return slot->hash == hash && slot->len == len && memcmp(slot->data, data, len) == 0;
+}
+
+int BlobSetGrowRehash(BlobSet* set)
+{
+    uint32_t oldCapacity = set->capacity;
+    uint8_t* oldOccupancy = set->occupancy;
+    BlobSetSlot* oldSlots = set->slots;
+
+    // resize
+    uint32_t capacity = oldCapacity * 2;
+    uint8_t* occupancy = (uint8_t*)calloc((capacity + 7) >> 3, 1);
+    BlobSetSlot* slots = (BlobSetSlot*)malloc(sizeof(BlobSetSlot) * capacity);
+    if (occupancy == NULL || slots == NULL) {
+        free(occupancy);
+        free(slots);
+        return 0;
+    }
+    set->capacity = capacity;
+    set->occupancy = occupancy;
+    set->slots = slots;
+    set->maxProbes = 1;
+
+    // re-insert slots using their stored hash
+    for (uint32_t j=0; j<oldCapacity; j++) {
+        if (oldOccupancy[j >> 3] & (1u << (j & 7))) {
+            uint32_t probes = 0;
+            while (probes < set->capacity) {
+                uint32_t i = (oldSlots[j].hash + probes) % set->capacity;
+                if (!BlobSetSlotPresent(set, i)) {
+                    set->slots[i] = oldSlots[j];
+                    BlobSetMarkSlot(set, i);
+                    break;
+                }
+                probes++;
+            }
+            if (probes + 1 > set->maxProbes) set->maxProbes = probes + 1;
+        }
+    }
+
+    free(oldOccupancy);
+    free(oldSlots);
+    return 1;
+}
+
+char* BlobSetAddBlob(BlobSet* set, const void* data, uint32_t len)
+{
+    char* stored;
+
+    // search chunks for space
+    for (uint32_t i=set->allocSearchStart; i<set->chunkArraySize; i++) {
+        BlobSetChunk* chunk = &set->chunkArray[i];
+        if (chunk->capacity - chunk->used >= len) {
+            stored = chunk->buffer + chunk->used;
+            memcpy(stored, data, len);
+            chunk->used += len;
+            return stored;
+        }
+        else if (chunk->capacity - chunk->used < 20)
+        {
+            set->allocSearchStart = i + 1;
+        }
+    }
+
+    // no space? -> add new chunk
+    if (set->chunkArrayCapacity == set->chunkArraySize) {
+        BlobSetChunk* chunkArray = (BlobSetChunk*)realloc(set->chunkArray, sizeof(BlobSetChunk) * set->chunkArrayCapacity * 2);
+        if (chunkArray == NULL) return NULL;
+        set->chunkArray = chunkArray;
+        set->chunkArrayCapacity *= 2;
+    }
+    uint32_t newChunkCap = set->totalChunkCapacity;
+    if (newChunkCap < len * 2) newChunkCap = len * 2;
+    BlobSetChunk* newChunk = &set->chunkArray[set->chunkArraySize];
+    newChunk->buffer = (char*)malloc(newChunkCap);
+    if (newChunk->buffer == NULL) return NULL;
+    newChunk->capacity = newChunkCap;
+    newChunk->used = len;
+    set->chunkArraySize++;
+    set->totalChunkCapacity += newChunkCap;
+
+    // copy blob into new chunk
+    stored = newChunk->buffer;
+    memcpy(stored, data, len);
+    return stored;
+}
+
+// returns 1 if blob was added, 0 if already present, -1 on allocation failure
+int BlobSetInsert(BlobSet* set, const void* data, uint32_t len)
+{
+    // resize if surpassed max load factor
+    if (set->count * 10 > set->capacity * 7) {
+        if (!BlobSetGrowRehash(set)) {
+            return -1;
+        }
+    }
+
+    uint32_t probes = 0;
+    uint32_t hash = BlobSetHash(data, len);
+    while (probes < set->capacity) {
+        uint32_t i = (hash + probes) % set->capacity;
+
+        if (BlobSetSlotPresent(set, i)) {
+            if (BlobSetSlotMatches(&set->slots[i], data, len, hash)) return 0;
+        }
+        else
+        {
+            char* stored = BlobSetAddBlob(set, data, len);
+            if (stored == NULL) return -1;
+            BlobSetMarkSlot(set, i);
+            set->slots[i].data = stored;
+            set->slots[i].len = len;
+            set->slots[i].hash = hash;
+            set->count++;
+            break;
+        }
+        probes++;
+    }
+    if (probes + 1 > set->maxProbes) set->maxProbes = probes + 1;
+    return 1;
+}
+
+int BlobSetContains(BlobSet* set, const void* data, uint32_t len)
+{
+    uint32_t probes = 0;
+    uint32_t hash = BlobSetHash(data, len);
+    while (probes < set->maxProbes) {
+        uint32_t i = (hash + probes) % set->capacity;
+        if (!BlobSetSlotPresent(set, i)) return 0;
+        if (BlobSetSlotMatches(&set->slots[i], data, len, hash)) return 1;
+        probes++;
+    }
+    return 0;
+}
+
+// arena bytes of removed blobs are reclaimed by BlobSetClear
+void BlobSetRemove(BlobSet* set, const void* data, uint32_t len)
+{
+    uint32_t probes = 0;
+    uint32_t hash = BlobSetHash(data, len);
+
+    int holeIndex = -1;
+    while (probes < set->maxProbes) {
+        uint32_t i = (hash + probes) % set->capacity;
+        if (!BlobSetSlotPresent(set, i)) break;
+        if (BlobSetSlotMatches(&set->slots[i], data, len, hash)) {
+            holeIndex = (int)i;
+            BlobSetClearSlot(set, i);
+            break;
+        }
+        probes++;
+    }
+
+    if (holeIndex == -1) return; // blob not in set
+
+    uint32_t hole = (uint32_t)holeIndex;
+    uint32_t i = (hole + 1) % set->capacity;
+    while (BlobSetSlotPresent(set, i)) {
+        uint32_t candidateHome = set->slots[i].hash % set->capacity;
+
+        // can the candidate move into the hole?
+        int canMoveCandidate;
+        if (hole <= i)
+            canMoveCandidate = (candidateHome <= hole || candidateHome > i);
+        else
+            canMoveCandidate = (candidateHome <= hole && candidateHome > i);
+
+        if (!canMoveCandidate) {
+            i = (i + 1) % set->capacity;
+            continue;
+        }
+
+        // move candidate into the hole
+        set->slots[hole] = set->slots[i];
+        BlobSetClearSlot(set, i);
+        BlobSetMarkSlot(set, hole);
+
+        hole = i;
+        i = (i + 1) % set->capacity;
+    }
+
+    set->count--;
+}
+
+// empties the set but keeps the table and every arena chunk
+void BlobSetClear(BlobSet* set)
+{
+    memset(set->occupancy, 0, (set->capacity + 7) >> 3);
+    for (uint32_t i=0; i<set->chunkArraySize; i++) set->chunkArray[i].used = 0;
+    set->allocSearchStart = 0;
+    set->count = 0;
+    set->maxProbes = 1;
+}
+
+BlobSetIterator BlobSetCreateIterator(BlobSet* set)
+{
+    BlobSetIterator iterator;
+    iterator.set = set;
+    iterator.index = 0;
+    return iterator;
+}
+
+int BlobSetIteratorNext(BlobSetIterator* it, const void** dataOut, uint32_t* lenOut)
+{
+    BlobSet* set = it->set;
+
+    // no items -> done
+    if (set->count == 0) {
+        return 0;
+    }
+
+    while (it->index < set->capacity) {
+
+        // found blob -> set data, length
+        if (BlobSetSlotPresent(set, it->index)) {
+            *dataOut = set->slots[it->index].data;
+            *lenOut = set->slots[it->index].len;
+            it->index++;
+            return 1;
+        }
+        it->index++;
+    }
+
+    // done -> reset index
+    it->index = 0;
+    return 0;
+}
@@ -0,0 +1,285 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Insert-only Set that many threads can use at once without a mutex.
+// Each slot has a state byte claimed with compare-and-swap:
+//   EMPTY -> BUSY (item being written) -> FULL
+// On resize every slot of the old table is frozen as MOVED. Threads that run
+// into a resize help copy chunks of slots, then wait until every chunk has
+// been copied before switching to the new table. This is not lock-free: a
+// resize is blocking, and a thread descheduled while copying a chunk (or while
+// its slot is BUSY) stalls the others until it runs again. Old tables stay
+// allocated until ConcurrentSetFree since other threads may still be reading them.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define CSET_PAUSE() _mm_pause()
+#else
+#define CSET_PAUSE() ((void)0)
+#endif
+
+#define CSET_MIGRATE_CHUNK 1024
+
+enum { CSET_EMPTY = 0, CSET_BUSY = 1, CSET_FULL = 2, CSET_MOVED = 3 };
+
+typedef struct ConcurrentSetTable
+{
+    _Atomic(uint8_t)* states;
+    uint32_t* hashes;
+    char* data;
+    uint32_t capacity; // power of two
+    _Atomic(uint32_t) count;
+    _Atomic(uint32_t) migrateNext; // next slot chunk to copy
+    _Atomic(uint32_t) migrateDone; // slots copied
+    _Atomic(struct ConcurrentSetTable*) next;
+    struct ConcurrentSetTable* retired; // previous table
+} ConcurrentSetTable;
+
+typedef struct ConcurrentSet
+{
+    _Atomic(ConcurrentSetTable*) table;
+    uint32_t itemSize;
+} ConcurrentSet;
+
+// FNV algorithm https://github.com/aappleby/smhasher/blob/master/src/Hashes.cpp
+static uint32_t ConcurrentSetHash(const void* item, uint32_t len)
+{
+    uint32_t hash = 2166136261u;
+    const uint8_t* p = (const uint8_t*)item;
+    for (uint32_t i=0; i<len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static ConcurrentSetTable* ConcurrentSetTableCreate(uint32_t itemSize, uint32_t capacity)
+{
+    ConcurrentSetTable* table = (ConcurrentSetTable*)malloc(sizeof(ConcurrentSetTable));
+    if (table == NULL) return NULL;
+    table->states = (_Atomic(uint8_t)*)calloc(capacity, sizeof(_Atomic(uint8_t)));
+    table->hashes = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    table->data = (char*)malloc((size_t)capacity * itemSize);
+    if (table->states == NULL || table->hashes == NULL || table->data == NULL) {
+        free((void*)table->states);
+        free(table->hashes);
+        free(table->data);
+        free(table);
+        return NULL;
+    }
+    table->capacity = capacity;
+    atomic_init(&table->count, 0);
+    atomic_init(&table->migrateNext, 0);
+    atomic_init(&table->migrateDone, 0);
+    atomic_init(&table->next, NULL);
+    table->retired = NULL;
+    return table;
+}
+
+int ConcurrentSetInit(ConcurrentSet* set, uint32_t itemSize, uint32_t capacity)
+{
+    uint32_t rounded = 64;
+    while (rounded < capacity) rounded <<= 1;
+    ConcurrentSetTable* table = ConcurrentSetTableCreate(itemSize, rounded);
+    if (table == NULL) return 0;
+    set->itemSize = itemSize;
+    atomic_init(&set->table, table);
+    return 1;
+}
+
+// not thread safe; call once every thread is done with the set
+void ConcurrentSetFree(ConcurrentSet* set)
+{
+    ConcurrentSetTable* table = atomic_load(&set->table);
+    while (table) {
+        ConcurrentSetTable* retired = table->retired;
+        free((void*)table->states);
+        free(table->hashes);
+        free(table->data);
+        free(table);
+        table = retired;
+    }
+    atomic_store(&set->table, NULL);
+}
+
+// 1 = inserted, 0 = already present, -1 = table moved or full
+static int ConcurrentSetTableInsert(ConcurrentSetTable* table, uint32_t itemSize, const void* item, uint32_t hash)
+{
+    uint32_t mask = table->capacity - 1;
+    for (uint32_t probes=0; probes<table->capacity; probes++) {
+        uint32_t i = (hash + probes) & mask;
+        uint8_t state = atomic_load_explicit(&table->states[i], memory_order_acquire);
+
+        // free slot -> try to claim it
+        if (state == CSET_EMPTY) {
+            uint8_t expected = CSET_EMPTY;
+            if (atomic_compare_exchange_strong(&table->states[i], &expected, CSET_BUSY)) {
+                table->hashes[i] = hash;
+                memcpy(table->data + (size_t)i * itemSize, item, itemSize);
+                atomic_store_explicit(&table->states[i], CSET_FULL, memory_order_release);
+                atomic_fetch_add_explicit(&table->count, 1, memory_order_relaxed);
+                return 1;
+            }
+            state = expected; // lost the race -> inspect the winner
+        }
+
+        // another thread is writing -> wait so duplicates are caught
+        while (state == CSET_BUSY) {
+            CSET_PAUSE();
+            state = atomic_load_explicit(&table->states[i], memory_order_acquire);
+        }
+        if (state == CSET_MOVED) return -1;
+
+        if (table->hashes[i] == hash && memcmp(table->data + (size_t)i * itemSize, item, itemSize) == 0) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// 1 = found, 0 = not found, -1 = table moved
+static int ConcurrentSetTableFind(ConcurrentSetTable* table, uint32_t itemSize, const void* item, uint32_t hash)
+{
+    uint32_t mask = table->capacity - 1;
+    for (uint32_t probes=0; probes<table->capacity; probes++) {
+        uint32_t i = (hash + probes) & mask;
+        uint8_t state = atomic_load_explicit(&table->states[i], memory_order_acquire);
+        while (state == CSET_BUSY) {
+            CSET_PAUSE();
+            state = atomic_load_explicit(&table->states[i], memory_order_acquire);
+        }
+        if (state == CSET_EMPTY) return 0;
+        if (state == CSET_MOVED) return -1;
+        if (table->hashes[i] == hash && memcmp(table->data + (size_t)i * itemSize, item, itemSize) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void ConcurrentSetMigrateSlot(ConcurrentSetTable* table, ConcurrentSetTable* next, uint32_t itemSize, uint32_t i)
+{
+    for (;;) {
+        uint8_t state = atomic_load_explicit(&table->states[i], memory_order_acquire);
+        if (state == CSET_EMPTY) {
+            uint8_t expected = CSET_EMPTY;
+            if (atomic_compare_exchange_strong(&table->states[i], &expected, CSET_MOVED)) return;
+            continue;
+        }
+        if (state == CSET_BUSY) { // insert in flight -> let it finish
+            CSET_PAUSE();
+            continue;
+        }
+        if (state == CSET_FULL) {
+            ConcurrentSetTableInsert(next, itemSize, table->data + (size_t)i * itemSize, table->hashes[i]);
+            atomic_store_explicit(&table->states[i], CSET_MOVED, memory_order_release);
+        }
+        return;
+    }
+}
+
+// copy chunks of table into table->next until none are left, then block
+// until the other helpers finish theirs and publish the new table
+static void ConcurrentSetHelpMigrate(ConcurrentSet* set, ConcurrentSetTable* table)
+{
+    ConcurrentSetTable* next = atomic_load(&table->next);
+    for (;;) {
+        uint32_t start = atomic_fetch_add(&table->migrateNext, CSET_MIGRATE_CHUNK);
+        if (start >= table->capacity) break;
+        uint32_t end = start + CSET_MIGRATE_CHUNK;
+        if (end > table->capacity) end = table->capacity;
+        for (uint32_t i=start; i<end; i++) {
+            ConcurrentSetMigrateSlot(table, next, set->itemSize, i);
+        }
+        atomic_fetch_add(&table->migrateDone, end - start);
+    }
+
+    while (atomic_load(&table->migrateDone) < table->capacity) CSET_PAUSE();
+    ConcurrentSetTable* expected = table;
+    atomic_compare_exchange_strong(&set->table, &expected, next);
+}
+
+static void ConcurrentSetStartResize(ConcurrentSet* set, ConcurrentSetTable* table)
+{
+    if (atomic_load(&table->next) == NULL) {
+        ConcurrentSetTable* next = ConcurrentSetTableCreate(set->itemSize, table->capacity * 2);
+        if (next == NULL) return;
+        next->retired = table;
+        ConcurrentSetTable* expected = NULL;
+        if (!atomic_compare_exchange_strong(&table->next, &expected, next)) {
+            free((void*)next->states);
+            free(next->hashes);
+            free(next->data);
+            free(next);
+        }
+    }
+    if (atomic_load(&table->next) != NULL) ConcurrentSetHelpMigrate(set, table);
+}
+
+// Returns 1 if item was new, 0 if it was already in the set, -1 if the set
+// could not grow.
+int ConcurrentSetInsert(ConcurrentSet* set, const void* item)
+{
+    uint32_t hash = ConcurrentSetHash(item, set->itemSize);
+    for (;;) {
+        ConcurrentSetTable* table = atomic_load(&set->table);
+        if (atomic_load(&table->next) != NULL) {
+            ConcurrentSetHelpMigrate(set, table);
+            continue;
+        }
+
+        // resize if surpassed max load factor
+        uint32_t count = atomic_load_explicit(&table->count, memory_order_relaxed);
+        if ((uint64_t)count * 10 >= (uint64_t)table->capacity * 7) {
+            ConcurrentSetStartResize(set, table);
+            if (atomic_load(&table->next) == NULL) return -1;
+            continue;
+        }
+
+        int result = ConcurrentSetTableInsert(table, set->itemSize, item, hash);
+        if (result >= 0) return result;
+        ConcurrentSetStartResize(set, table);
+        if (atomic_load(&table->next) == NULL) return -1;
+    }
+}
+
+int ConcurrentSetContains(ConcurrentSet* set, const void* item)
+{
+    uint32_t hash = ConcurrentSetHash(item, set->itemSize);
+    for (;;) {
+        ConcurrentSetTable* table = atomic_load(&set->table);
+        int result = ConcurrentSetTableFind(table, set->itemSize, item, hash);
+        if (result >= 0) return result;
+        ConcurrentSetHelpMigrate(set, table);
+    }
+}
+
+// exact once inserting threads have finished
+uint32_t ConcurrentSetCount(ConcurrentSet* set)
+{
+    ConcurrentSetTable* table = atomic_load(&set->table);
+    return atomic_load(&table->count);
+}
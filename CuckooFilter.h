@@ -0,0 +1,390 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Approximate membership filter (cuckoo filter, Fan et al. 2014).
+// Contains() never gives a false negative for an added item. False positives
+// occur at roughly 8 / 2^fingerprintBits: ~3% with 8 bit fingerprints and
+// ~0.01% with 16 bit fingerprints. Remove() must only be given added items.
+// Add() returns 0 once full; the Set/Stringmap companions then rebuild the
+// filter at twice the size from the backing table.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "Set.h"
+#include "Stringmap.h"
+
+#define CUCKOO_BUCKET_SIZE 4
+#define CUCKOO_MAX_KICKS 500
+
+typedef struct CuckooFilter
+{
+    uint8_t* buckets;          // bucketCount * CUCKOO_BUCKET_SIZE fingerprints, 0 = empty
+    uint32_t bucketCount;      // power of two
+    uint32_t fingerprintBytes; // 1 or 2
+    uint32_t count;
+    uint32_t seed;             // kick selection
+    uint32_t victimIndex;      // item evicted by a failed insert
+    uint16_t victimFingerprint;
+    uint8_t hasVictim;
+} CuckooFilter;
+
+int CuckooFilterInit(CuckooFilter* filter, uint32_t capacity, float falsePositiveRate)
+{
+    // smallest whole byte fingerprint that reaches the requested rate
+    filter->fingerprintBytes = falsePositiveRate >= 2.0f * CUCKOO_BUCKET_SIZE / 256.0f ? 1 : 2;
+
+    // buckets for capacity at 95% load, rounded up to a power of two
+    uint32_t needed = (uint32_t)(capacity / (CUCKOO_BUCKET_SIZE * 0.95f)) + 1;
+    filter->bucketCount = 1;
+    while (filter->bucketCount < needed) filter->bucketCount <<= 1;
+
+    filter->buckets = (uint8_t*)calloc((size_t)filter->bucketCount * CUCKOO_BUCKET_SIZE, filter->fingerprintBytes);
+    if (filter->buckets == NULL) return 0;
+    filter->count = 0;
+    filter->seed = 2463534242u;
+    filter->victimIndex = 0;
+    filter->victimFingerprint = 0;
+    filter->hasVictim = 0;
+    return 1;
+}
+
+void CuckooFilterFree(CuckooFilter* filter)
+{
+    free(filter->buckets);
+    filter->buckets = NULL;
+    filter->bucketCount = 0;
+    filter->count = 0;
+    filter->hasVictim = 0;
+}
+
+void CuckooFilterClear(CuckooFilter* filter)
+{
+    memset(filter->buckets, 0, (size_t)filter->bucketCount * CUCKOO_BUCKET_SIZE * filter->fingerprintBytes);
+    filter->count = 0;
+    filter->hasVictim = 0;
+}
+
+// 64 bit FNV-1a with a murmur3 finaliser so both halves are well mixed
+static uint64_t CuckooFilterHash(const void* data, uint32_t len)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* p = (const uint8_t*)data;
+    for (uint32_t i=0; i<len; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static inline uint16_t CuckooFilterGet(CuckooFilter* filter, uint32_t bucket, uint32_t slot)
+{
+    uint32_t i = bucket * CUCKOO_BUCKET_SIZE + slot;
+    if (filter->fingerprintBytes == 1) return filter->buckets[i];
+    uint16_t fp;
+    memcpy(&fp, filter->buckets + i * 2, 2);
+    return fp;
+}
+
+static inline void CuckooFilterPut(CuckooFilter* filter, uint32_t bucket, uint32_t slot, uint16_t fp)
+{
+    uint32_t i = bucket * CUCKOO_BUCKET_SIZE + slot;
+    if (filter->fingerprintBytes == 1) filter->buckets[i] = (uint8_t)fp;
+    else memcpy(filter->buckets + i * 2, &fp, 2);
+}
+
+static inline uint32_t CuckooFilterAltIndex(CuckooFilter* filter, uint32_t index, uint16_t fp)
+{
+    return (index ^ (fp * 0x5bd1e995u)) & (filter->bucketCount - 1);
+}
+
+static inline void CuckooFilterLocate(CuckooFilter* filter, const void* data, uint32_t len, uint32_t* index, uint16_t* fp)
+{
+    uint64_t hash = CuckooFilterHash(data, len);
+    uint32_t fpMask = filter->fingerprintBytes == 1 ? 0xFF : 0xFFFF;
+    *index = (uint32_t)hash & (filter->bucketCount - 1);
+    *fp = (uint16_t)((hash >> 32) & fpMask);
+    if (*fp == 0) *fp = 1; // 0 marks an empty slot
+}
+
+static int CuckooFilterBucketInsert(CuckooFilter* filter, uint32_t bucket, uint16_t fp)
+{
+    for (uint32_t s=0; s<CUCKOO_BUCKET_SIZE; s++) {
+        if (CuckooFilterGet(filter, bucket, s) == 0) {
+            CuckooFilterPut(filter, bucket, s, fp);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int CuckooFilterBucketHas(CuckooFilter* filter, uint32_t bucket, uint16_t fp)
+{
+    for (uint32_t s=0; s<CUCKOO_BUCKET_SIZE; s++) {
+        if (CuckooFilterGet(filter, bucket, s) == fp) return 1;
+    }
+    return 0;
+}
+
+static int CuckooFilterBucketRemove(CuckooFilter* filter, uint32_t bucket, uint16_t fp)
+{
+    for (uint32_t s=0; s<CUCKOO_BUCKET_SIZE; s++) {
+        if (CuckooFilterGet(filter, bucket, s) == fp) {
+            CuckooFilterPut(filter, bucket, s, 0);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// returns 0 when the filter is full
+int CuckooFilterAdd(CuckooFilter* filter, const void* data, uint32_t len)
+{
+    if (filter->hasVictim) return 0;
+
+    uint32_t i1;
+    uint16_t fp;
+    CuckooFilterLocate(filter, data, len, &i1, &fp);
+    uint32_t i2 = CuckooFilterAltIndex(filter, i1, fp);
+    if (CuckooFilterBucketInsert(filter, i1, fp) || CuckooFilterBucketInsert(filter, i2, fp)) {
+        filter->count++;
+        return 1;
+    }
+
+    // both buckets full -> relocate existing fingerprints
+    uint32_t index = (filter->seed & 1) ? i1 : i2;
+    for (uint32_t kick=0; kick<CUCKOO_MAX_KICKS; kick++) {
+        filter->seed ^= filter->seed << 13;
+        filter->seed ^= filter->seed >> 17;
+        filter->seed ^= filter->seed << 5;
+        uint32_t slot = filter->seed % CUCKOO_BUCKET_SIZE;
+
+        uint16_t evicted = CuckooFilterGet(filter, index, slot);
+        CuckooFilterPut(filter, index, slot, fp);
+        fp = evicted;
+        index = CuckooFilterAltIndex(filter, index, fp);
+        if (CuckooFilterBucketInsert(filter, index, fp)) {
+            filter->count++;
+            return 1;
+        }
+    }
+
+    // keep the homeless fingerprint so nothing is lost
+    filter->victimIndex = index;
+    filter->victimFingerprint = fp;
+    filter->hasVictim = 1;
+    filter->count++;
+    return 1;
+}
+
+int CuckooFilterContains(CuckooFilter* filter, const void* data, uint32_t len)
+{
+    uint32_t i1;
+    uint16_t fp;
+    CuckooFilterLocate(filter, data, len, &i1, &fp);
+    uint32_t i2 = CuckooFilterAltIndex(filter, i1, fp);
+    if (filter->hasVictim && filter->victimFingerprint == fp &&
+        (filter->victimIndex == i1 || filter->victimIndex == i2)) {
+        return 1;
+    }
+    return CuckooFilterBucketHas(filter, i1, fp) || CuckooFilterBucketHas(filter, i2, fp);
+}
+
+int CuckooFilterRemove(CuckooFilter* filter, const void* data, uint32_t len)
+{
+    uint32_t i1;
+    uint16_t fp;
+    CuckooFilterLocate(filter, data, len, &i1, &fp);
+    uint32_t i2 = CuckooFilterAltIndex(filter, i1, fp);
+
+    if (CuckooFilterBucketRemove(filter, i1, fp) || CuckooFilterBucketRemove(filter, i2, fp)) {
+        filter->count--;
+
+        // freed a slot -> try to re-home the victim
+        if (filter->hasVictim) {
+            uint32_t v1 = filter->victimIndex;
+            uint32_t v2 = CuckooFilterAltIndex(filter, v1, filter->victimFingerprint);
+            if (CuckooFilterBucketInsert(filter, v1, filter->victimFingerprint) ||
+                CuckooFilterBucketInsert(filter, v2, filter->victimFingerprint)) {
+                filter->hasVictim = 0;
+            }
+        }
+        return 1;
+    }
+    if (filter->hasVictim && filter->victimFingerprint == fp &&
+        (filter->victimIndex == i1 || filter->victimIndex == i2)) {
+        filter->hasVictim = 0;
+        filter->count--;
+        return 1;
+    }
+    return 0;
+}
+
+// ------------------------------------------------------
+// --- Set / Stringmap companions ---
+// ------------------------------------------------------
+
+// empty filter with like's fingerprint width and seed but bucketCount buckets
+static int CuckooFilterInitBuckets(CuckooFilter* filter, const CuckooFilter* like, uint32_t bucketCount)
+{
+    *filter = *like;
+    filter->buckets = (uint8_t*)calloc((size_t)bucketCount * CUCKOO_BUCKET_SIZE, like->fingerprintBytes);
+    if (filter->buckets == NULL) return 0;
+    filter->bucketCount = bucketCount;
+    filter->count = 0;
+    filter->hasVictim = 0;
+    return 1;
+}
+
+static int CuckooFilterFillFromSet(CuckooFilter* filter, Set* set)
+{
+    SetIterator it = SetCreateIterator(set);
+    void* item;
+    while (SetIteratorNext(&it, &item)) {
+        if (!CuckooFilterAdd(filter, item, set->itemSize)) return 0;
+    }
+    return 1;
+}
+
+static int CuckooFilterFillFromStringmap(CuckooFilter* filter, Stringmap* map)
+{
+    StringmapIterator it = StringmapCreateIterator(map);
+    char* key;
+    uint32_t len;
+    void* value;
+    while (StringmapIteratorNextN(&it, &key, &len, &value)) {
+        if (!CuckooFilterAdd(filter, key, len)) return 0;
+    }
+    return 1;
+}
+
+// filter is full -> double it (again if needed) and re-add everything from
+// the backing table
+static int CuckooFilterRebuildFromSet(CuckooFilter* filter, Set* set)
+{
+    // fill a separate filter so a failure leaves the current one intact
+    CuckooFilter larger;
+    uint32_t bucketCount = filter->bucketCount;
+    for (;;) {
+        if (bucketCount >= 0x80000000u) return 0;
+        bucketCount <<= 1;
+        if (!CuckooFilterInitBuckets(&larger, filter, bucketCount)) return 0;
+        if (CuckooFilterFillFromSet(&larger, set)) break;
+        CuckooFilterFree(&larger);
+    }
+    CuckooFilterFree(filter);
+    *filter = larger;
+    return 1;
+}
+
+static int CuckooFilterRebuildFromStringmap(CuckooFilter* filter, Stringmap* map)
+{
+    // fill a separate filter so a failure leaves the current one intact
+    CuckooFilter larger;
+    uint32_t bucketCount = filter->bucketCount;
+    for (;;) {
+        if (bucketCount >= 0x80000000u) return 0;
+        bucketCount <<= 1;
+        if (!CuckooFilterInitBuckets(&larger, filter, bucketCount)) return 0;
+        if (CuckooFilterFillFromStringmap(&larger, map)) break;
+        CuckooFilterFree(&larger);
+    }
+    CuckooFilterFree(filter);
+    *filter = larger;
+    return 1;
+}
+
+// sized from the table capacity so inserts up to its next resize fit
+int CuckooFilterFromSet(CuckooFilter* filter, Set* set, float falsePositiveRate)
+{
+    if (!CuckooFilterInit(filter, set->capacity, falsePositiveRate)) return 0;
+    if (CuckooFilterFillFromSet(filter, set) || CuckooFilterRebuildFromSet(filter, set)) return 1;
+    CuckooFilterFree(filter);
+    return 0;
+}
+
+int CuckooFilterFromStringmap(CuckooFilter* filter, Stringmap* map, float falsePositiveRate)
+{
+    if (!CuckooFilterInit(filter, map->capacity, falsePositiveRate)) return 0;
+    if (CuckooFilterFillFromStringmap(filter, map) || CuckooFilterRebuildFromStringmap(filter, map)) return 1;
+    CuckooFilterFree(filter);
+    return 0;
+}
+
+// SetInsert that keeps filter in sync, grows the filter when full.
+// returns 0 (and leaves item out of set) if the filter cannot grow
+int CuckooFilterSetInsert(CuckooFilter* filter, Set* set, void* item)
+{
+    if (SetContains(set, item)) return 1;
+    SetInsert(set, item);
+    if (CuckooFilterAdd(filter, item, set->itemSize)) return 1;
+    if (CuckooFilterRebuildFromSet(filter, set)) return 1;
+    SetRemove(set, item);
+    return 0;
+}
+
+// SetRemove that keeps filter in sync
+void CuckooFilterSetRemove(CuckooFilter* filter, Set* set, void* item)
+{
+    if (!SetContains(set, item)) return;
+    SetRemove(set, item);
+    CuckooFilterRemove(filter, item, set->itemSize);
+}
+
+// filter rejects most misses before the table is touched
+int CuckooFilterSetContains(CuckooFilter* filter, Set* set, void* item)
+{
+    if (!CuckooFilterContains(filter, item, set->itemSize)) return 0;
+    return SetContains(set, item);
+}
+
+// StringmapSet that keeps filter in sync, grows the filter when full.
+// returns NULL (and leaves key out of map) if the filter cannot grow
+void* CuckooFilterStringmapSet(CuckooFilter* filter, Stringmap* map, char* key, void* value)
+{
+    int existed = StringmapContains(map, key);
+    void* stored = StringmapSet(map, key, value);
+    if (stored == NULL || existed) return stored;
+    if (CuckooFilterAdd(filter, key, (uint32_t)strlen(key))) return stored;
+    if (CuckooFilterRebuildFromStringmap(filter, map)) return stored;
+    StringmapDelete(map, key);
+    return NULL;
+}
+
+// StringmapDelete that keeps filter in sync
+void CuckooFilterStringmapDelete(CuckooFilter* filter, Stringmap* map, char* key)
+{
+    if (!StringmapContains(map, key)) return;
+    StringmapDelete(map, key);
+    CuckooFilterRemove(filter, key, (uint32_t)strlen(key));
+}
+
+void* CuckooFilterStringmapGet(CuckooFilter* filter, Stringmap* map, char* key)
+{
+    if (!CuckooFilterContains(filter, key, (uint32_t)strlen(key))) return NULL;
+    return StringmapGet(map, key);
+}
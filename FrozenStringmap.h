@@ -0,0 +1,327 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Read-only string map built from a Stringmap or LinearStringmap with a
+// minimal perfect hash (PTHash style). Keys are split into buckets and each
+// bucket stores a pilot value chosen so that every key of the bucket lands on
+// a distinct free slot of a table with exactly count slots. A lookup is one
+// pilot load, one slot and one key compare. Keys are packed NUL terminated in
+// one blob in slot order.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Stringmap.h"
+#include "LinearStringmap.h"
+
+#define FROZEN_MAX_SEEDS 16
+#define FROZEN_MAX_PILOT 0x00FFFFFFu
+
+typedef struct FrozenStringmap
+{
+    uint64_t seed;
+    uint32_t count;
+    uint32_t bucketCount;
+    uint32_t denseBuckets; // buckets receiving the dense 60% of keys
+    uint32_t itemSize;
+    uint32_t* pilots;
+    uint32_t* offsets; // count + 1 offsets into keys
+    char* keys;
+    void* values;
+} FrozenStringmap;
+
+typedef struct FrozenStringmapEntry
+{
+    const char* key;
+    uint32_t len;
+    uint32_t bucket;
+    void* value;
+    uint64_t hash;
+} FrozenStringmapEntry;
+
+// FNV algorithm https://github.com/aappleby/smhasher/blob/master/src/Hashes.cpp
+static inline uint64_t FrozenStringmapHash(const char* key, uint32_t len, uint64_t seed)
+{
+    uint64_t hash = 14695981039346656037ull ^ seed;
+    const uint8_t* p = (const uint8_t*)key;
+    for (uint32_t i=0; i<len; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// murmur3 finalizer
+static inline uint64_t FrozenStringmapMix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// 60% of keys go to the first 30% of buckets so large buckets are placed
+// while the table is still empty
+static inline uint32_t FrozenStringmapBucket(FrozenStringmap* map, uint64_t hash)
+{
+    uint64_t mixed = FrozenStringmapMix(hash);
+    uint32_t hi = (uint32_t)(mixed >> 32);
+    uint32_t lo = (uint32_t)mixed;
+    if (hi < 2576980377u) return lo % map->denseBuckets;
+    return map->denseBuckets + lo % (map->bucketCount - map->denseBuckets);
+}
+
+static inline uint32_t FrozenStringmapSlot(FrozenStringmap* map, uint64_t hash, uint32_t pilot)
+{
+    return (uint32_t)(FrozenStringmapMix(hash ^ FrozenStringmapMix(pilot + 1)) % map->count);
+}
+
+void FrozenStringmapFree(FrozenStringmap* map)
+{
+    if (!map) return;
+    free(map->pilots);
+    free(map->offsets);
+    free(map->keys);
+    free(map->values);
+    map->pilots = NULL;
+    map->offsets = NULL;
+    map->keys = NULL;
+    map->values = NULL;
+    map->count = 0;
+    map->bucketCount = 0;
+}
+
+// choose pilots for one seed; fills slotOf[entry]
+static int FrozenStringmapPlace(FrozenStringmap* map, FrozenStringmapEntry* entries, uint32_t* slotOf)
+{
+    uint32_t count = map->count;
+    uint32_t bucketCount = map->bucketCount;
+    int result = 0;
+
+    uint32_t* bucketStart = (uint32_t*)calloc(bucketCount + 1, sizeof(uint32_t));
+    uint32_t* members = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    uint32_t* order = (uint32_t*)malloc(sizeof(uint32_t) * bucketCount);
+    uint64_t* taken = (uint64_t*)calloc((count + 63) / 64, sizeof(uint64_t));
+    uint32_t* sizeStart = NULL;
+    if (bucketStart == NULL || members == NULL || order == NULL || taken == NULL) goto done;
+
+    // group entries by bucket
+    uint32_t maxSize = 0;
+    for (uint32_t i=0; i<count; i++) {
+        entries[i].hash = FrozenStringmapHash(entries[i].key, entries[i].len, map->seed);
+        entries[i].bucket = FrozenStringmapBucket(map, entries[i].hash);
+        bucketStart[entries[i].bucket + 1]++;
+    }
+    for (uint32_t b=0; b<bucketCount; b++) {
+        uint32_t size = bucketStart[b + 1];
+        if (size > maxSize) maxSize = size;
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    for (uint32_t i=0; i<count; i++) {
+        members[bucketStart[entries[i].bucket]++] = i;
+    }
+    for (uint32_t b=bucketCount; b>0; b--) bucketStart[b] = bucketStart[b - 1];
+    bucketStart[0] = 0;
+
+    // order buckets largest first
+    sizeStart = (uint32_t*)calloc(maxSize + 2, sizeof(uint32_t));
+    if (sizeStart == NULL) goto done;
+    for (uint32_t b=0; b<bucketCount; b++) {
+        sizeStart[maxSize - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+    }
+    for (uint32_t s=0; s<=maxSize; s++) sizeStart[s + 1] += sizeStart[s];
+    for (uint32_t b=0; b<bucketCount; b++) {
+        order[sizeStart[maxSize - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+    }
+
+    for (uint32_t o=0; o<bucketCount; o++) {
+        uint32_t b = order[o];
+        uint32_t* bucket = members + bucketStart[b];
+        uint32_t size = bucketStart[b + 1] - bucketStart[b];
+        map->pilots[b] = 0;
+        if (size == 0) continue;
+
+        // equal hashes in one bucket can never separate -> try another seed
+        for (uint32_t i=0; i<size; i++) {
+            for (uint32_t j=i+1; j<size; j++) {
+                if (entries[bucket[i]].hash == entries[bucket[j]].hash) goto done;
+            }
+        }
+
+        uint32_t pilot = 0;
+        for (;; pilot++) {
+            if (pilot > FROZEN_MAX_PILOT) goto done;
+            uint32_t placed = 0;
+            for (; placed<size; placed++) {
+                uint32_t slot = FrozenStringmapSlot(map, entries[bucket[placed]].hash, pilot);
+                if (taken[slot >> 6] & (1ull << (slot & 63))) break;
+                taken[slot >> 6] |= 1ull << (slot & 63);
+                slotOf[bucket[placed]] = slot;
+            }
+            if (placed == size) break;
+
+            // collision -> release this attempt
+            for (uint32_t i=0; i<placed; i++) {
+                uint32_t slot = slotOf[bucket[i]];
+                taken[slot >> 6] &= ~(1ull << (slot & 63));
+            }
+        }
+        map->pilots[b] = pilot;
+    }
+    result = 1;
+
+done:
+    free(bucketStart);
+    free(members);
+    free(order);
+    free(taken);
+    free(sizeStart);
+    return result;
+}
+
+static int FrozenStringmapBuild(FrozenStringmap* map, FrozenStringmapEntry* entries, uint32_t count, uint32_t itemSize)
+{
+    memset(map, 0, sizeof(FrozenStringmap));
+    map->itemSize = itemSize;
+    map->count = count;
+    map->bucketCount = count / 4 + 1;
+    map->denseBuckets = map->bucketCount * 3 / 10;
+    if (map->denseBuckets == 0) map->denseBuckets = 1;
+    if (map->denseBuckets == map->bucketCount) map->bucketCount++;
+
+    uint64_t keyBytes = 0;
+    for (uint32_t i=0; i<count; i++) keyBytes += (uint64_t)entries[i].len + 1;
+    if (keyBytes > 0xFFFFFFFFu) return 0;
+
+    map->pilots = (uint32_t*)malloc(sizeof(uint32_t) * map->bucketCount);
+    map->offsets = (uint32_t*)malloc(sizeof(uint32_t) * (count + 1));
+    map->keys = (char*)malloc(keyBytes ? keyBytes : 1);
+    map->values = malloc(itemSize * (count ? count : 1));
+    uint32_t* slotOf = (uint32_t*)malloc(sizeof(uint32_t) * (count ? count : 1));
+    uint32_t* entryAt = (uint32_t*)malloc(sizeof(uint32_t) * (count ? count : 1));
+    if (map->pilots == NULL || map->offsets == NULL || map->keys == NULL || map->values == NULL || slotOf == NULL || entryAt == NULL) {
+        free(slotOf);
+        free(entryAt);
+        FrozenStringmapFree(map);
+        return 0;
+    }
+
+    // find pilots, changing seed on failure
+    int placed = count == 0;
+    for (uint32_t attempt=0; !placed && attempt<FROZEN_MAX_SEEDS; attempt++) {
+        map->seed = FrozenStringmapMix(0x9E3779B97F4A7C15ull * (attempt + 1));
+        placed = FrozenStringmapPlace(map, entries, slotOf);
+    }
+    if (!placed) {
+        free(slotOf);
+        free(entryAt);
+        FrozenStringmapFree(map);
+        return 0;
+    }
+
+    // pack keys and values in slot order
+    for (uint32_t i=0; i<count; i++) entryAt[slotOf[i]] = i;
+    uint32_t offset = 0;
+    for (uint32_t s=0; s<count; s++) {
+        FrozenStringmapEntry* entry = &entries[entryAt[s]];
+        map->offsets[s] = offset;
+        memcpy(map->keys + offset, entry->key, entry->len);
+        map->keys[offset + entry->len] = '\0';
+        offset += entry->len + 1;
+        memcpy((char*)map->values + (size_t)s * itemSize, entry->value, itemSize);
+    }
+    map->offsets[count] = offset;
+
+    free(slotOf);
+    free(entryAt);
+    return 1;
+}
+
+int FrozenStringmapFromStringmap(FrozenStringmap* frozen, Stringmap* map)
+{
+    FrozenStringmapEntry* entries = (FrozenStringmapEntry*)malloc(sizeof(FrozenStringmapEntry) * (map->itemCount ? map->itemCount : 1));
+    if (entries == NULL) return 0;
+    uint32_t count = 0;
+    StringmapIterator it = StringmapCreateIterator(map);
+    char* key;
+    uint32_t len;
+    void* value;
+    while (StringmapIteratorNextN(&it, &key, &len, &value)) {
+        entries[count].key = key;
+        entries[count].len = len;
+        entries[count].value = value;
+        count++;
+    }
+    int result = FrozenStringmapBuild(frozen, entries, count, map->itemSize);
+    free(entries);
+    return result;
+}
+
+int FrozenStringmapFromLinearStringmap(FrozenStringmap* frozen, LinearStringmap* map)
+{
+    FrozenStringmapEntry* entries = (FrozenStringmapEntry*)malloc(sizeof(FrozenStringmapEntry) * (map->itemCount ? map->itemCount : 1));
+    if (entries == NULL) return 0;
+    uint32_t count = 0;
+    LinearStringmapIterator it = LinearStringmapCreateIterator(map);
+    char* key;
+    void* value;
+    while (LinearStringmapIteratorNext(&it, &key, &value)) {
+        entries[count].key = key;
+        entries[count].len = (uint32_t)strlen(key);
+        entries[count].value = value;
+        count++;
+    }
+    int result = FrozenStringmapBuild(frozen, entries, count, map->itemSize);
+    free(entries);
+    return result;
+}
+
+// key is len bytes without NUL terminator
+void* FrozenStringmapGetN(FrozenStringmap* map, const char* key, uint32_t len)
+{
+    if (map->count == 0) return NULL;
+    uint64_t hash = FrozenStringmapHash(key, len, map->seed);
+    uint32_t slot = FrozenStringmapSlot(map, hash, map->pilots[FrozenStringmapBucket(map, hash)]);
+    uint32_t offset = map->offsets[slot];
+    if (map->offsets[slot + 1] - offset != len + 1 || memcmp(map->keys + offset, key, len) != 0) {
+        return NULL;
+    }
+    return (char*)map->values + (size_t)slot * map->itemSize;
+}
+
+void* FrozenStringmapGet(FrozenStringmap* map, char* key)
+{
+    return FrozenStringmapGetN(map, key, (uint32_t)strlen(key));
+}
+
+int FrozenStringmapContains(FrozenStringmap* map, char* key)
+{
+    return FrozenStringmapGet(map, key) != NULL;
+}
+
+// NUL terminated key stored in slot
+inline char* FrozenStringmapKey(FrozenStringmap* map, uint32_t slot)
+{
+    return map->keys + map->offsets[slot];
+}
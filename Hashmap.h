@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdbool.h>
 
 // ------------------------------------------------------
 // --- Datastructure For Mapping (generic -> generic) ---
@@ -295,6 +296,48 @@ void HashmapDelete(Hashmap* hmap, void* key)
 }
 
 
+// Removes every entry for which keep() returns 0 in one pass over the table.
+// Kept entries behind a removed one are re-seated from their home slot, so
+// probe chains stay intact without a backward shift per deletion.
+uint32_t HashmapRetainIf(Hashmap* hmap, int (*keep)(void* key, void* value, void* userData), void* userData)
+{
+    if (hmap->itemCount == 0) return 0;
+    uint32_t slotSize = hmap->keySize + hmap->itemSize;
+
+    // start at an empty slot so no probe chain wraps past the scan start
+    uint32_t start = 0;
+    while (start < hmap->capacity && HashmapSlotPresent(hmap, start)) start++;
+
+    uint32_t removed = 0;
+    int holeInRun = 0;
+    for (uint32_t n=1; n<=hmap->capacity; n++) {
+        uint32_t i = (start + n) % hmap->capacity;
+        if (!HashmapSlotPresent(hmap, i)) { // end of probe run
+            holeInRun = 0;
+            continue;
+        }
+
+        char* base = (char*)hmap->data + i * slotSize;
+        if (!keep(base, base + hmap->keySize, userData)) {
+            HashmapClearSlot(hmap, i);
+            removed++;
+            holeInRun = 1;
+            continue;
+        }
+        if (!holeInRun) continue; // nothing to close up yet
+
+        // move item to the first free slot from its home
+        HashmapClearSlot(hmap, i);
+        uint32_t j = HashGeneric(base, hmap->keySize) % hmap->capacity;
+        while (HashmapSlotPresent(hmap, j)) j = (j + 1) % hmap->capacity;
+        if (j != i) memcpy((char*)hmap->data + j * slotSize, base, slotSize);
+        HashmapMarkSlot(hmap, j);
+    }
+
+    hmap->itemCount -= removed;
+    return removed;
+}
+
 HashmapIterator HashmapCreateIterator(Hashmap* hmap)
 {
     HashmapIterator iterator;
@@ -2,12 +2,16 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include "StringHash.h"
+
+#define LINEAR_STRINGMAP_RETAIN_ALL 0xFFFFFFFFu
 
 typedef struct LinearStringmapChunk
 {
     char* buffer;
     uint32_t capacity;
     uint32_t used;
+    uint32_t dead; // bytes of deleted keys
 } LinearStringmapChunk;
 
 typedef struct LinearStringmap
@@ -26,12 +30,22 @@ typedef struct LinearStringmap
     uint32_t itemSize;
     uint32_t itemCount;
     uint32_t maxProbes;
+    uint32_t hashKind; // STRING_HASH_FNV or STRING_HASH_WIDE
 } LinearStringmap;
 
+typedef struct LinearStringmapIterator
+{
+    LinearStringmap* map;
+    uint32_t index;
+} LinearStringmapIterator;
+
 void LinearStringmapFree(LinearStringmap* map)
 {
     if (!map) return;
-    if (map->chunkArray) free(map->chunkArray);
+    if (map->chunkArray) {
+        for (uint32_t c=0; c<map->chunkArraySize; c++) free(map->chunkArray[c].buffer);
+        free(map->chunkArray);
+    }
     if (map->occupancy) free(map->occupancy);
     if (map->map) free(map->map);
     map->chunkArray = NULL;
@@ -65,6 +79,7 @@ int LinearStringmapInit(LinearStringmap* map, uint32_t itemSize, uint32_t mapCap
     }
     map->chunkArray[0].capacity = chunkCapacity;
     map->chunkArray[0].used = 0;
+    map->chunkArray[0].dead = 0;
 
     // create hashmap
     map->mapCapacity = mapCapacity;
@@ -79,11 +94,20 @@ int LinearStringmapInit(LinearStringmap* map, uint32_t itemSize, uint32_t mapCap
     map->itemSize = itemSize;
     map->itemCount = 0;
     map->maxProbes = 1;
+    map->hashKind = STRING_HASH_FNV;
 
     // success
     return 1;
 }
 
+// hashKind selects the key hash, see StringHash.h
+int LinearStringmapInitHash(LinearStringmap* map, uint32_t itemSize, uint32_t mapCapacity, uint32_t chunkCapacity, uint32_t hashKind)
+{
+    if (!LinearStringmapInit(map, itemSize, mapCapacity, chunkCapacity)) return 0;
+    map->hashKind = hashKind;
+    return 1;
+}
+
 uint32_t LinearStringmapHash(char* string) {
     uint32_t hash = 2166136261u;
     for (uint8_t* p = (uint8_t*)string; *p; p++) {
@@ -93,6 +117,43 @@ uint32_t LinearStringmapHash(char* string) {
     return hash;
 }
 
+uint32_t LinearStringmapHashN(const char* key, uint32_t len) {
+    uint32_t hash = 2166136261u;
+    const uint8_t* p = (const uint8_t*)key;
+    for (uint32_t i=0; i<len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// hash and measure the key in one pass
+static inline uint32_t LinearStringmapHashLen(char* string, uint32_t* lenOut) {
+    uint32_t hash = 2166136261u;
+    uint8_t* p = (uint8_t*)string;
+    for (; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    *lenOut = (uint32_t)(p - (uint8_t*)string);
+    return hash;
+}
+
+static inline uint32_t LinearStringmapKeyHash(LinearStringmap* map, const char* key, uint32_t len)
+{
+    if (map->hashKind == STRING_HASH_WIDE) return StringHashWide(key, len);
+    return LinearStringmapHashN(key, len);
+}
+
+static inline uint32_t LinearStringmapKeyHashLen(LinearStringmap* map, char* key, uint32_t* lenOut)
+{
+    if (map->hashKind == STRING_HASH_WIDE) {
+        *lenOut = (uint32_t)strlen(key);
+        return StringHashWide(key, *lenOut);
+    }
+    return LinearStringmapHashLen(key, lenOut);
+}
+
 static inline uint8_t LinearStringmapSlotPresent(LinearStringmap* map, uint32_t i)
 {
     return map->occupancy[i >> 3] & (1u << (i & 7));
@@ -145,7 +206,8 @@ int LinearStringmapGrowRehash(LinearStringmap* map)
 
             // add item
             uint32_t probes = 0;
-            uint32_t hash = LinearStringmapHash(key);
+            uint32_t len;
+            uint32_t hash = LinearStringmapKeyHashLen(map, key, &len);
             while(probes < map->mapCapacity) {
                 uint32_t i = (hash + probes) % map->mapCapacity;
                 if (!LinearStringmapSlotPresent(map, i)) {
@@ -160,14 +222,15 @@ int LinearStringmapGrowRehash(LinearStringmap* map)
             if (probes + 1 > map->maxProbes) map->maxProbes = probes + 1;
         }
     }
+    free(oldOccupancy);
+    free(oldMap);
     return 1;
 }
 
-char* LinearStringmapAddKey(LinearStringmap* map, char* key)
+char* LinearStringmapAddKeyN(LinearStringmap* map, const char* key, uint32_t keyLen)
 {
     char* storedKey;
-    uint32_t keyLen = strlen(key);
-    
+
     // search chunks for space
     for (uint32_t i=map->allocSearchStart; i<map->chunkArraySize; i++) {
         LinearStringmapChunk* chunk = &map->chunkArray[i];
@@ -186,19 +249,21 @@ char* LinearStringmapAddKey(LinearStringmap* map, char* key)
 
     // no space? -> add new chunk
     if (map->chunkArrayCapacity == map->chunkArraySize) {
+        LinearStringmapChunk* chunkArray = (LinearStringmapChunk*)realloc(map->chunkArray, sizeof(LinearStringmapChunk) * map->chunkArrayCapacity * 2);
+        if (chunkArray == NULL) return NULL;
+        map->chunkArray = chunkArray;
         map->chunkArrayCapacity *= 2;
-        map->chunkArray = (LinearStringmapChunk*)realloc(map->chunkArray, sizeof(LinearStringmapChunk) * map->chunkArrayCapacity);
-        if (map->chunkArray == NULL) return NULL;
     }
-    map->chunkArraySize++;
     uint32_t newChunkCap = map->totalChunkCapacity;
-    if (newChunkCap < keyLen * 2) newChunkCap = keyLen * 2;
-    map->totalChunkCapacity += newChunkCap;
-    LinearStringmapChunk* newChunk = &map->chunkArray[map->chunkArraySize - 1];
-    newChunk->capacity = newChunkCap;
+    if (newChunkCap < keyLen * 2 + 2) newChunkCap = keyLen * 2 + 2;
+    LinearStringmapChunk* newChunk = &map->chunkArray[map->chunkArraySize];
     newChunk->buffer = (char*)malloc(newChunkCap);
     if (newChunk->buffer == NULL) return NULL;
+    newChunk->capacity = newChunkCap;
     newChunk->used = keyLen + 1;
+    newChunk->dead = 0;
+    map->chunkArraySize++;
+    map->totalChunkCapacity += newChunkCap;
 
     // copy key into new chunk
     storedKey = (char*)newChunk->buffer;
@@ -207,7 +272,21 @@ char* LinearStringmapAddKey(LinearStringmap* map, char* key)
     return storedKey;
 }
 
-int LinearStringmapSet(LinearStringmap* map, char* key, void* value)
+char* LinearStringmapAddKey(LinearStringmap* map, char* key)
+{
+    return LinearStringmapAddKeyN(map, key, (uint32_t)strlen(key));
+}
+
+// stored key equals the len byte key (stops at the stored NUL, never reads past it)
+static inline int LinearStringmapKeyMatches(const char* storedKey, const char* key, uint32_t len)
+{
+    for (uint32_t k=0; k<len; k++) {
+        if (storedKey[k] != key[k] || storedKey[k] == '\0') return 0;
+    }
+    return storedKey[len] == '\0';
+}
+
+static int LinearStringmapSetHashed(LinearStringmap* map, const char* key, uint32_t len, uint32_t hash, void* value)
 {
     // resize if surpassed max load factor
     if (map->itemCount * 10 > map->mapCapacity * 7) {
@@ -217,7 +296,6 @@ int LinearStringmapSet(LinearStringmap* map, char* key, void* value)
     }
 
     uint32_t probes = 0;
-    uint32_t hash = LinearStringmapHash(key);
     while(probes < map->mapCapacity) {
         uint32_t i = (hash + probes) % map->mapCapacity;
 
@@ -225,16 +303,16 @@ int LinearStringmapSet(LinearStringmap* map, char* key, void* value)
         if (LinearStringmapSlotPresent(map, i)) {
             char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
             char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
+            if (LinearStringmapKeyMatches(storedKey, key, len)) {
                 memcpy(base + sizeof(char*), value, map->itemSize);
                 return 1;
             }
         }
         else
         {
-            LinearStringmapMarkSlot(map, i);
-            char* storedKey = LinearStringmapAddKey(map, key);
+            char* storedKey = LinearStringmapAddKeyN(map, key, len);
             if (storedKey == NULL) return 0;
+            LinearStringmapMarkSlot(map, i);
 
             char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
             memcpy(base, &storedKey, sizeof(char*));
@@ -248,38 +326,318 @@ int LinearStringmapSet(LinearStringmap* map, char* key, void* value)
     return 1;
 }
 
-void* LinearStringmapGet(LinearStringmap* map, char* key)
+static void* LinearStringmapGetHashed(LinearStringmap* map, const char* key, uint32_t len, uint32_t hash)
 {
     uint32_t probes = 0;
-    uint32_t hash = LinearStringmapHash(key);
-    while(probes < map->mapCapacity) {
+    while(probes < map->maxProbes) {
         uint32_t i = (hash + probes) % map->mapCapacity;
-        if (LinearStringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
-                return (char*)base + sizeof(char*);
-            }
+        if (!LinearStringmapSlotPresent(map, i)) return NULL;
+        char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
+        char* storedKey = *(char**)base;
+        if (LinearStringmapKeyMatches(storedKey, key, len)) {
+            return (char*)base + sizeof(char*);
         }
         probes++;
     }
     return NULL;
 }
 
+// arena copy of the key stored in front of a value returned by Get
+static inline char* LinearStringmapValueKey(void* value)
+{
+    char* key;
+    memcpy(&key, (char*)value - sizeof(char*), sizeof(char*));
+    return key;
+}
+
+int LinearStringmapSet(LinearStringmap* map, char* key, void* value)
+{
+    uint32_t len;
+    uint32_t hash = LinearStringmapKeyHashLen(map, key, &len);
+    return LinearStringmapSetHashed(map, key, len, hash, value);
+}
+
+// key is len bytes without NUL terminator; keys may not contain NUL bytes
+int LinearStringmapSetN(LinearStringmap* map, const char* key, uint32_t len, void* value)
+{
+    return LinearStringmapSetHashed(map, key, len, LinearStringmapKeyHash(map, key, len), value);
+}
+
+// *String variants take a String from String.h (uint32 length, then the bytes)
+// read here directly so this header does not depend on String.h.
+// As with the *N variants the String must not contain NUL bytes.
+static inline uint32_t LinearStringmapStringLen(const unsigned char* str)
+{
+    uint32_t len;
+    memcpy(&len, str, 4);
+    return len;
+}
+
+static inline const char* LinearStringmapStringData(const unsigned char* str)
+{
+    return (const char*)str + 4;
+}
+
+int LinearStringmapSetString(LinearStringmap* map, const unsigned char* key, void* value)
+{
+    return LinearStringmapSetN(map, LinearStringmapStringData(key), LinearStringmapStringLen(key), value);
+}
+
+void* LinearStringmapGet(LinearStringmap* map, char* key)
+{
+    uint32_t len;
+    uint32_t hash = LinearStringmapKeyHashLen(map, key, &len);
+    return LinearStringmapGetHashed(map, key, len, hash);
+}
+
+// stored keys end at their NUL, so a key containing NUL is never found
+void* LinearStringmapGetN(LinearStringmap* map, const char* key, uint32_t len)
+{
+    return LinearStringmapGetHashed(map, key, len, LinearStringmapKeyHash(map, key, len));
+}
+
+void* LinearStringmapGetString(LinearStringmap* map, const unsigned char* key)
+{
+    return LinearStringmapGetN(map, LinearStringmapStringData(key), LinearStringmapStringLen(key));
+}
+
 int LinearStringmapContains(LinearStringmap* map, char* key)
 {
+    return LinearStringmapGet(map, key) != NULL;
+}
+
+int LinearStringmapContainsN(LinearStringmap* map, const char* key, uint32_t len)
+{
+    return LinearStringmapGetN(map, key, len) != NULL;
+}
+
+int LinearStringmapContainsString(LinearStringmap* map, const unsigned char* key)
+{
+    return LinearStringmapGetN(map, LinearStringmapStringData(key), LinearStringmapStringLen(key)) != NULL;
+}
+
+// chunk holding an arena key, -1 if none
+static int LinearStringmapKeyChunk(LinearStringmap* map, const char* storedKey)
+{
+    for (uint32_t c=0; c<map->chunkArraySize; c++) {
+        LinearStringmapChunk* chunk = &map->chunkArray[c];
+        if (storedKey >= chunk->buffer && storedKey < chunk->buffer + chunk->capacity) return (int)c;
+    }
+    return -1;
+}
+
+static void LinearStringmapDeleteHashed(LinearStringmap* map, const char* key, uint32_t len, uint32_t hash)
+{
+    uint32_t slotSize = sizeof(char*) + map->itemSize;
     uint32_t probes = 0;
-    uint32_t hash = LinearStringmapHash(key);
+
+    int holeIndex = -1;
     while(probes < map->maxProbes) {
         uint32_t i = (hash + probes) % map->mapCapacity;
-        if (LinearStringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
-                return 1;
-            }
+        if (!LinearStringmapSlotPresent(map, i)) break;
+        char* base = (char*)map->map + i * slotSize;
+        char* storedKey;
+        memcpy(&storedKey, base, sizeof(char*));
+        if (LinearStringmapKeyMatches(storedKey, key, len)) {
+            holeIndex = (int)i;
+            LinearStringmapClearSlot(map, i);
+
+            // key bytes stay in the chunk until compaction
+            int c = LinearStringmapKeyChunk(map, storedKey);
+            if (c >= 0) map->chunkArray[c].dead += len + 1;
+            break;
         }
         probes++;
     }
+
+    if (holeIndex == -1) return; // key not found
+
+    uint32_t hole = (uint32_t)holeIndex;
+    uint32_t i = (hole + 1) % map->mapCapacity;
+    while (LinearStringmapSlotPresent(map, i))
+    {
+        char* candidate = (char*)map->map + i * slotSize;
+        char* candidateKey;
+        memcpy(&candidateKey, candidate, sizeof(char*));
+        uint32_t candidateLen;
+        uint32_t candidateHome = LinearStringmapKeyHashLen(map, candidateKey, &candidateLen) % map->mapCapacity;
+
+        // can the candidate move into the hole?
+        int canMoveCandidate;
+        if (hole <= i)
+            canMoveCandidate = (candidateHome <= hole || candidateHome > i);
+        else
+            canMoveCandidate = (candidateHome <= hole && candidateHome > i);
+
+        if (!canMoveCandidate) {
+            i = (i + 1) % map->mapCapacity;
+            continue;
+        }
+
+        // move candidate into the hole
+        memcpy((char*)map->map + hole * slotSize, candidate, slotSize);
+
+        LinearStringmapClearSlot(map, i);
+        LinearStringmapMarkSlot(map, hole);
+
+        hole = i;
+        i = (i + 1) % map->mapCapacity;
+    }
+
+    map->itemCount--;
+}
+
+void LinearStringmapDelete(LinearStringmap* map, char* key)
+{
+    uint32_t len;
+    uint32_t hash = LinearStringmapKeyHashLen(map, key, &len);
+    LinearStringmapDeleteHashed(map, key, len, hash);
+}
+
+void LinearStringmapDeleteN(LinearStringmap* map, const char* key, uint32_t len)
+{
+    LinearStringmapDeleteHashed(map, key, len, LinearStringmapKeyHash(map, key, len));
+}
+
+void LinearStringmapDeleteString(LinearStringmap* map, const unsigned char* key)
+{
+    LinearStringmapDeleteN(map, LinearStringmapStringData(key), LinearStringmapStringLen(key));
+}
+
+// Moves the live keys out of up to maxChunks chunks that are at least half
+// dead, rewrites their slots and frees the drained chunks. Call it every so
+// often to bound arena growth under key churn. Moved keys get new addresses,
+// so key pointers from Get/iterators taken earlier are invalidated.
+// Returns the number of chunks freed.
+uint32_t LinearStringmapCompact(LinearStringmap* map, uint32_t maxChunks)
+{
+    uint32_t slotSize = sizeof(char*) + map->itemSize;
+
+    // pick victims; filling them up keeps AddKey from allocating into them
+    uint32_t victimCount = 0;
+    uint32_t savedUsed[8];
+    int victims[8];
+    if (maxChunks > 8) maxChunks = 8;
+    for (uint32_t c=0; c<map->chunkArraySize && victimCount<maxChunks; c++) {
+        LinearStringmapChunk* chunk = &map->chunkArray[c];
+        if (chunk->dead == 0 || chunk->dead * 2 < chunk->used) continue;
+        victims[victimCount] = (int)c;
+        savedUsed[victimCount] = chunk->used;
+        chunk->used = chunk->capacity;
+        victimCount++;
+    }
+    if (victimCount == 0) return 0;
+
+    // move live keys out of victims
+    for (uint32_t i=0; i<map->mapCapacity; i++) {
+        if (!LinearStringmapSlotPresent(map, i)) continue;
+        char* base = (char*)map->map + i * slotSize;
+        char* storedKey;
+        memcpy(&storedKey, base, sizeof(char*));
+        for (uint32_t v=0; v<victimCount; v++) {
+            LinearStringmapChunk* chunk = &map->chunkArray[victims[v]];
+            if (storedKey < chunk->buffer || storedKey >= chunk->buffer + chunk->capacity) continue;
+
+            uint32_t len = (uint32_t)strlen(storedKey);
+            char* movedKey = LinearStringmapAddKeyN(map, storedKey, len);
+            if (movedKey == NULL) {
+
+                // out of memory -> keep victims, moved copies count as dead
+                for (uint32_t r=0; r<victimCount; r++) {
+                    map->chunkArray[victims[r]].used = savedUsed[r];
+                }
+                return 0;
+            }
+            chunk = &map->chunkArray[victims[v]]; // AddKey may realloc chunkArray
+            chunk->dead += len + 1;
+            memcpy(base, &movedKey, sizeof(char*));
+            break;
+        }
+    }
+
+    // free drained chunks, last to first so indices stay valid
+    uint32_t freed = 0;
+    for (uint32_t v=victimCount; v>0; v--) {
+        uint32_t c = (uint32_t)victims[v - 1];
+        LinearStringmapChunk* chunk = &map->chunkArray[c];
+        if (map->chunkArraySize == 1) {
+            chunk->used = 0;
+            chunk->dead = 0;
+            break;
+        }
+        free(chunk->buffer);
+        map->totalChunkCapacity -= chunk->capacity;
+        memmove(chunk, chunk + 1, sizeof(LinearStringmapChunk) * (map->chunkArraySize - c - 1));
+        map->chunkArraySize--;
+        freed++;
+    }
+    map->allocSearchStart = 0;
+    return freed;
+}
+
+// Removes every key but keeps the table and chunk buffers so the map can be
+// refilled without allocating. Chunks are kept in order while their total
+// capacity fits in retainBytes (the first chunk is always kept) and the rest
+// are freed. Pass LINEAR_STRINGMAP_RETAIN_ALL to keep everything.
+void LinearStringmapReset(LinearStringmap* map, uint32_t retainBytes)
+{
+    uint32_t occupancyBytes = (map->mapCapacity + 7) >> 3;
+    memset(map->occupancy, 0, occupancyBytes);
+    map->itemCount = 0;
+    map->maxProbes = 1;
+
+    // rewind kept chunks, free the rest
+    uint64_t retained = 0;
+    uint32_t kept = 0;
+    for (uint32_t c=0; c<map->chunkArraySize; c++) {
+        LinearStringmapChunk* chunk = &map->chunkArray[c];
+        if (c == 0 || retained + chunk->capacity <= retainBytes) {
+            chunk->used = 0;
+            chunk->dead = 0;
+            retained += chunk->capacity;
+            map->chunkArray[kept++] = *chunk;
+        }
+        else
+        {
+            free(chunk->buffer);
+        }
+    }
+    map->chunkArraySize = kept;
+    map->totalChunkCapacity = (uint32_t)retained;
+    map->allocSearchStart = 0;
+}
+
+LinearStringmapIterator LinearStringmapCreateIterator(LinearStringmap* map)
+{
+    LinearStringmapIterator iterator;
+    iterator.map = map;
+    iterator.index = 0;
+    return iterator;
+}
+
+int LinearStringmapIteratorNext(LinearStringmapIterator* it, char** keyOut, void** valOut)
+{
+    LinearStringmap* map = it->map;
+
+    // no items -> done
+    if (map->itemCount == 0) {
+        return 0;
+    }
+
+    while (it->index < map->mapCapacity) {
+
+        // found item -> set key, value
+        if (LinearStringmapSlotPresent(map, it->index)) {
+            char* base = (char*)map->map + it->index * (sizeof(char*) + map->itemSize);
+            it->index++;
+            memcpy(keyOut, base, sizeof(char*));
+            *valOut = base + sizeof(char*);
+            return 1;
+        }
+        it->index++;
+    }
+
+    // done -> reset index
+    it->index = 0;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,326 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Bulk loader that builds a LinearStringmap from a newline separated key file.
+// The file is mapped copy-on-write and every '\n' (and a preceding '\r') is
+// overwritten with '\0', so the keys are used in place and never copied into
+// the arena. Line ends are found 16 bytes at a time with SSE2 and the keys are
+// split between threads for hashing. The table is sized from the line count
+// up front so inserts skip the load factor check. The key file must stay open
+// until the map is freed.
+
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LinearStringmap.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(_WIN32) && !defined(LSMAP_NO_MMAP)
+#define LSMAP_NO_MMAP
+#endif
+#if defined(_WIN32) && !defined(LSMAP_NO_THREADS)
+#define LSMAP_NO_THREADS
+#endif
+#if !defined(LSMAP_NO_MMAP)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if !defined(LSMAP_NO_THREADS)
+#include <pthread.h>
+#endif
+
+#define LSMAP_MAX_THREADS 64
+
+typedef struct LinearStringmapKeyFile
+{
+    char* data;
+    size_t size; // data[size - 1] is always '\n'
+    size_t mappedSize;
+    int mapped; // 0 = data is a malloc'd copy
+} LinearStringmapKeyFile;
+
+typedef struct LinearStringmapBulkKey
+{
+    char* key;
+    uint32_t len;
+    uint32_t hash;
+} LinearStringmapBulkKey;
+
+typedef struct LinearStringmapBulkTask
+{
+    char* begin;
+    char* end; // one past the task's last '\n'
+    LinearStringmapBulkKey* keys;
+    uint32_t count;
+    uint32_t hashKind;
+    int fill; // 0 = count lines, 1 = split and hash
+} LinearStringmapBulkTask;
+
+void LinearStringmapKeyFileClose(LinearStringmapKeyFile* file)
+{
+    if (file->data) {
+#if !defined(LSMAP_NO_MMAP)
+        if (file->mapped) munmap(file->data, file->mappedSize);
+        else free(file->data);
+#else
+        free(file->data);
+#endif
+    }
+    memset(file, 0, sizeof(LinearStringmapKeyFile));
+}
+
+// read the file into a buffer with room for a final '\n'
+static int LinearStringmapKeyFileRead(LinearStringmapKeyFile* file, const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    if (fseek(f, 0, SEEK_END) != 0) {
+        fclose(f);
+        return 0;
+    }
+    long size = ftell(f);
+    rewind(f);
+    if (size < 0) {
+        fclose(f);
+        return 0;
+    }
+    file->data = (char*)malloc((size_t)size + 1);
+    if (file->data == NULL || fread(file->data, 1, (size_t)size, f) != (size_t)size) {
+        free(file->data);
+        file->data = NULL;
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    file->size = (size_t)size;
+    if (file->size == 0 || file->data[file->size - 1] != '\n') file->data[file->size++] = '\n';
+    file->mapped = 0;
+    return 1;
+}
+
+static int LinearStringmapKeyFileOpen(LinearStringmapKeyFile* file, const char* path)
+{
+    memset(file, 0, sizeof(LinearStringmapKeyFile));
+#if !defined(LSMAP_NO_MMAP)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    // private writable mapping; needs a final '\n' to terminate the last key
+    // (lseek + read rather than pread, which strict -std=c11 does not declare)
+    char last = 0;
+    if (st.st_size > 0 && lseek(fd, st.st_size - 1, SEEK_SET) == st.st_size - 1
+        && read(fd, &last, 1) == 1 && last == '\n') {
+        void* data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) return 0;
+        file->data = (char*)data;
+        file->size = (size_t)st.st_size;
+        file->mappedSize = (size_t)st.st_size;
+        file->mapped = 1;
+        return 1;
+    }
+    close(fd);
+#endif
+    return LinearStringmapKeyFileRead(file, path);
+}
+
+static inline int LinearStringmapBulkTrailingZeros(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while ((x & 1) == 0) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+static inline int LinearStringmapBulkPopcount(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(x);
+#else
+    int n = 0;
+    while (x) { x &= x - 1; n++; }
+    return n;
+#endif
+}
+
+// record one line ending at nl
+static inline void LinearStringmapBulkLine(LinearStringmapBulkTask* task, char** lineStart, char* nl)
+{
+    char* key = *lineStart;
+    uint32_t len = (uint32_t)(nl - key);
+    *nl = '\0';
+    if (len > 0 && key[len - 1] == '\r') key[--len] = '\0';
+    LinearStringmapBulkKey* out = &task->keys[task->count++];
+    out->key = key;
+    out->len = len;
+    out->hash = task->hashKind == STRING_HASH_WIDE ? StringHashWide(key, len) : LinearStringmapHashN(key, len);
+    *lineStart = nl + 1;
+}
+
+static void* LinearStringmapBulkRun(void* arg)
+{
+    LinearStringmapBulkTask* task = (LinearStringmapBulkTask*)arg;
+    char* p = task->begin;
+    char* lineStart = task->begin;
+    task->count = 0;
+
+#if defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; p + 16 <= task->end; p += 16) {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), newline));
+        if (!task->fill) {
+            task->count += LinearStringmapBulkPopcount(mask);
+            continue;
+        }
+        while (mask) {
+            LinearStringmapBulkLine(task, &lineStart, p + LinearStringmapBulkTrailingZeros(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; p < task->end; p++) {
+        if (*p != '\n') continue;
+        if (!task->fill) task->count++;
+        else LinearStringmapBulkLine(task, &lineStart, p);
+    }
+    return NULL;
+}
+
+// run tasks on threads, falling back to the calling thread
+static void LinearStringmapBulkRunAll(LinearStringmapBulkTask* tasks, uint32_t taskCount)
+{
+#if !defined(LSMAP_NO_THREADS)
+    pthread_t threads[LSMAP_MAX_THREADS];
+    int started[LSMAP_MAX_THREADS];
+    for (uint32_t t=1; t<taskCount; t++) {
+        started[t] = pthread_create(&threads[t], NULL, LinearStringmapBulkRun, &tasks[t]) == 0;
+        if (!started[t]) LinearStringmapBulkRun(&tasks[t]);
+    }
+    LinearStringmapBulkRun(&tasks[0]);
+    for (uint32_t t=1; t<taskCount; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+    }
+#else
+    for (uint32_t t=0; t<taskCount; t++) LinearStringmapBulkRun(&tasks[t]);
+#endif
+}
+
+// Builds map from the keys in path, one per line (empty lines are skipped,
+// duplicates kept once). Every value starts as a copy of value, or zeroed if
+// value is NULL. file owns the key bytes; close it after LinearStringmapFree.
+int LinearStringmapLoadKeys(LinearStringmap* map, LinearStringmapKeyFile* file, const char* path, uint32_t itemSize, const void* value, uint32_t hashKind, uint32_t threadCount)
+{
+    if (!LinearStringmapKeyFileOpen(file, path)) return 0;
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount > LSMAP_MAX_THREADS) threadCount = LSMAP_MAX_THREADS;
+
+    // split at line ends
+    LinearStringmapBulkTask tasks[LSMAP_MAX_THREADS];
+    char* end = file->data + file->size;
+    char* begin = file->data;
+    uint32_t taskCount = 0;
+    for (uint32_t t=0; t<threadCount && begin < end; t++) {
+        char* split = file->data + file->size / threadCount * (t + 1);
+        if (t == threadCount - 1 || split >= end) split = end;
+        else
+        {
+            if (split < begin) split = begin;
+            split = (char*)memchr(split, '\n', (size_t)(end - split)) + 1;
+        }
+        tasks[taskCount].begin = begin;
+        tasks[taskCount].end = split;
+        tasks[taskCount].hashKind = hashKind;
+        tasks[taskCount].fill = 0;
+        tasks[taskCount].keys = NULL;
+        taskCount++;
+        begin = split;
+    }
+
+    // count lines, then split and hash into one key array
+    LinearStringmapBulkRunAll(tasks, taskCount);
+    uint64_t lineCount = 0;
+    for (uint32_t t=0; t<taskCount; t++) lineCount += tasks[t].count;
+    if (lineCount > 0x7FFFFFFFu) {
+        LinearStringmapKeyFileClose(file);
+        return 0;
+    }
+    LinearStringmapBulkKey* keys = (LinearStringmapBulkKey*)malloc(sizeof(LinearStringmapBulkKey) * (lineCount ? lineCount : 1));
+    if (keys == NULL) {
+        LinearStringmapKeyFileClose(file);
+        return 0;
+    }
+    uint64_t offset = 0;
+    for (uint32_t t=0; t<taskCount; t++) {
+        tasks[t].keys = keys + offset;
+        offset += tasks[t].count;
+        tasks[t].fill = 1;
+    }
+    LinearStringmapBulkRunAll(tasks, taskCount);
+
+    // size the table so every key fits under the load factor
+    uint32_t mapCapacity = (uint32_t)(lineCount * 10 / 7) + 16;
+    if (!LinearStringmapInitHash(map, itemSize, mapCapacity, 512, hashKind)) {
+        free(keys);
+        LinearStringmapKeyFileClose(file);
+        return 0;
+    }
+
+    // insert keys in place, no arena copies
+    uint32_t slotSize = sizeof(char*) + itemSize;
+    for (uint64_t k=0; k<lineCount; k++) {
+        LinearStringmapBulkKey* key = &keys[k];
+        if (key->len == 0) continue;
+        uint32_t probes = 0;
+        while (probes < map->mapCapacity) {
+            uint32_t i = (key->hash + probes) % map->mapCapacity;
+            char* base = (char*)map->map + (size_t)i * slotSize;
+            if (!LinearStringmapSlotPresent(map, i)) {
+                memcpy(base, &key->key, sizeof(char*));
+                if (value) memcpy(base + sizeof(char*), value, itemSize);
+                else memset(base + sizeof(char*), 0, itemSize);
+                LinearStringmapMarkSlot(map, i);
+                map->itemCount++;
+                break;
+            }
+            char* storedKey;
+            memcpy(&storedKey, base, sizeof(char*));
+            if (LinearStringmapKeyMatches(storedKey, key->key, key->len)) break; // duplicate
+            probes++;
+        }
+        if (probes + 1 > map->maxProbes) map->maxProbes = probes + 1;
+    }
+
+    free(keys);
+    return 1;
+}
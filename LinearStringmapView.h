@@ -0,0 +1,301 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// FILE LAYOUT (native endianness, sections 8 byte aligned)
+// [LinearStringmapFileHeader][occupancy bits][slots][key blob]
+// slot: [uint32 key offset][uint32 key length][value][padding to 8 bytes]
+// Slots keep the positions they had in the saved map so a view probes exactly
+// like the map did. Keys are stored NUL terminated back to back in the blob.
+// LinearStringmapViewOpen maps the file read-only and answers lookups from the
+// mapping without parsing or copying.
+
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LinearStringmap.h"
+#if defined(_WIN32) && !defined(LSMAP_NO_MMAP)
+#define LSMAP_NO_MMAP
+#endif
+#if !defined(LSMAP_NO_MMAP)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define LSMAP_MAGIC "LSMAP001"
+
+typedef struct LinearStringmapFileHeader
+{
+    char magic[8];
+    uint32_t hashKind;
+    uint32_t itemSize;
+    uint32_t mapCapacity;
+    uint32_t itemCount;
+    uint32_t maxProbes;
+    uint32_t slotSize;
+    uint64_t occupancyOffset;
+    uint64_t slotsOffset;
+    uint64_t keysOffset;
+    uint64_t keysSize;
+} LinearStringmapFileHeader;
+
+typedef struct LinearStringmapView
+{
+    void* data;
+    size_t size;
+    int mapped; // 0 = data was read into a malloc'd buffer
+    const uint8_t* occupancy;
+    const char* slots;
+    const char* keys;
+    uint32_t hashKind;
+    uint32_t itemSize;
+    uint32_t mapCapacity;
+    uint32_t itemCount;
+    uint32_t maxProbes;
+    uint32_t slotSize;
+    uint64_t keysSize;
+} LinearStringmapView;
+
+static inline uint64_t LinearStringmapAlign8(uint64_t n)
+{
+    return (n + 7) & ~(uint64_t)7;
+}
+
+static int LinearStringmapWritePadding(FILE* file, uint64_t bytes)
+{
+    static const char zeros[8] = {0};
+    return bytes == 0 || fwrite(zeros, 1, (size_t)bytes, file) == bytes;
+}
+
+int LinearStringmapSave(LinearStringmap* map, const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return 0;
+
+    uint32_t slotSize = (uint32_t)LinearStringmapAlign8(8 + map->itemSize);
+    uint32_t occupancyBytes = (map->mapCapacity + 7) >> 3;
+    uint32_t mapSlotSize = sizeof(char*) + map->itemSize;
+
+    // total key bytes
+    uint64_t keysSize = 0;
+    for (uint32_t i=0; i<map->mapCapacity; i++) {
+        if (!LinearStringmapSlotPresent(map, i)) continue;
+        char* key;
+        memcpy(&key, (char*)map->map + (size_t)i * mapSlotSize, sizeof(char*));
+        keysSize += strlen(key) + 1;
+    }
+    if (keysSize > 0xFFFFFFFFu) {
+        fclose(file);
+        return 0;
+    }
+
+    LinearStringmapFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LSMAP_MAGIC, 8);
+    header.hashKind = map->hashKind;
+    header.itemSize = map->itemSize;
+    header.mapCapacity = map->mapCapacity;
+    header.itemCount = map->itemCount;
+    header.maxProbes = map->maxProbes;
+    header.slotSize = slotSize;
+    header.occupancyOffset = LinearStringmapAlign8(sizeof(header));
+    header.slotsOffset = LinearStringmapAlign8(header.occupancyOffset + occupancyBytes);
+    header.keysOffset = header.slotsOffset + (uint64_t)slotSize * map->mapCapacity;
+    header.keysSize = keysSize;
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && LinearStringmapWritePadding(file, header.occupancyOffset - sizeof(header));
+    ok = ok && fwrite(map->occupancy, 1, occupancyBytes, file) == occupancyBytes;
+    ok = ok && LinearStringmapWritePadding(file, header.slotsOffset - header.occupancyOffset - occupancyBytes);
+
+    // slots with key offsets in place of pointers
+    char* slot = (char*)calloc(1, slotSize);
+    if (slot == NULL) ok = 0;
+    uint32_t keyOffset = 0;
+    for (uint32_t i=0; ok && i<map->mapCapacity; i++) {
+        memset(slot, 0, slotSize);
+        if (LinearStringmapSlotPresent(map, i)) {
+            char* base = (char*)map->map + (size_t)i * mapSlotSize;
+            char* key;
+            memcpy(&key, base, sizeof(char*));
+            uint32_t len = (uint32_t)strlen(key);
+            memcpy(slot, &keyOffset, 4);
+            memcpy(slot + 4, &len, 4);
+            memcpy(slot + 8, base + sizeof(char*), map->itemSize);
+            keyOffset += len + 1;
+        }
+        ok = fwrite(slot, 1, slotSize, file) == slotSize;
+    }
+    free(slot);
+
+    // key blob in slot order
+    for (uint32_t i=0; ok && i<map->mapCapacity; i++) {
+        if (!LinearStringmapSlotPresent(map, i)) continue;
+        char* key;
+        memcpy(&key, (char*)map->map + (size_t)i * mapSlotSize, sizeof(char*));
+        size_t len = strlen(key) + 1;
+        ok = fwrite(key, 1, len, file) == len;
+    }
+
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+void LinearStringmapViewClose(LinearStringmapView* view)
+{
+    if (view->data) {
+#if !defined(LSMAP_NO_MMAP)
+        if (view->mapped) munmap(view->data, view->size);
+        else free(view->data);
+#else
+        free(view->data);
+#endif
+    }
+    memset(view, 0, sizeof(LinearStringmapView));
+}
+
+#if defined(LSMAP_NO_MMAP)
+// read whole file into memory where mmap is unavailable
+static int LinearStringmapViewRead(LinearStringmapView* view, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return 0;
+    }
+    long size = ftell(file);
+    rewind(file);
+    if (size <= 0) {
+        fclose(file);
+        return 0;
+    }
+    view->data = malloc((size_t)size);
+    if (view->data == NULL || fread(view->data, 1, (size_t)size, file) != (size_t)size) {
+        free(view->data);
+        view->data = NULL;
+        fclose(file);
+        return 0;
+    }
+    fclose(file);
+    view->size = (size_t)size;
+    view->mapped = 0;
+    return 1;
+}
+#endif
+
+int LinearStringmapViewOpen(LinearStringmapView* view, const char* path)
+{
+    memset(view, 0, sizeof(LinearStringmapView));
+#if !defined(LSMAP_NO_MMAP)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return 0;
+    view->data = data;
+    view->size = (size_t)st.st_size;
+    view->mapped = 1;
+#else
+    if (!LinearStringmapViewRead(view, path)) return 0;
+#endif
+
+    // validate header and section bounds
+    LinearStringmapFileHeader header;
+    if (view->size < sizeof(header)) {
+        LinearStringmapViewClose(view);
+        return 0;
+    }
+    memcpy(&header, view->data, sizeof(header));
+    // each section is checked against the file size before any offset is
+    // added, so hostile 64 bit values cannot wrap
+    uint64_t fileSize = (uint64_t)view->size;
+    uint64_t occupancyBytes = ((uint64_t)header.mapCapacity + 7) >> 3;
+    uint64_t slotsBytes = (uint64_t)header.slotSize * header.mapCapacity;
+    if (memcmp(header.magic, LSMAP_MAGIC, 8) != 0
+        || header.mapCapacity == 0
+        || header.slotSize < 8 + (uint64_t)header.itemSize
+        || header.occupancyOffset > fileSize || occupancyBytes > fileSize - header.occupancyOffset
+        || header.slotsOffset > fileSize || slotsBytes > fileSize - header.slotsOffset
+        || header.keysOffset > fileSize || header.keysSize > fileSize - header.keysOffset
+        || header.occupancyOffset + occupancyBytes > header.slotsOffset
+        || header.slotsOffset + slotsBytes > header.keysOffset) {
+        LinearStringmapViewClose(view);
+        return 0;
+    }
+
+    view->occupancy = (const uint8_t*)view->data + header.occupancyOffset;
+    view->slots = (const char*)view->data + header.slotsOffset;
+    view->keys = (const char*)view->data + header.keysOffset;
+    view->hashKind = header.hashKind;
+    view->itemSize = header.itemSize;
+    view->mapCapacity = header.mapCapacity;
+    view->itemCount = header.itemCount;
+    view->maxProbes = header.maxProbes;
+    view->slotSize = header.slotSize;
+    view->keysSize = header.keysSize;
+    return 1;
+}
+
+// key is len bytes without NUL terminator; value is read-only
+const void* LinearStringmapViewGetN(LinearStringmapView* view, const char* key, uint32_t len)
+{
+    uint32_t hash = view->hashKind == STRING_HASH_WIDE ? StringHashWide(key, len) : LinearStringmapHashN(key, len);
+    uint32_t probes = 0;
+    while(probes < view->maxProbes) {
+        uint32_t i = (hash + probes) % view->mapCapacity;
+        if (!(view->occupancy[i >> 3] & (1u << (i & 7)))) return NULL;
+        const char* slot = view->slots + (size_t)i * view->slotSize;
+        uint32_t keyOffset, keyLen;
+        memcpy(&keyOffset, slot, 4);
+        memcpy(&keyLen, slot + 4, 4);
+        // skip slots whose key and NUL do not lie inside the keys section
+        if (keyLen == len && (uint64_t)keyOffset + keyLen + 1 <= view->keysSize
+            && memcmp(view->keys + keyOffset, key, len) == 0) {
+            return slot + 8;
+        }
+        probes++;
+    }
+    return NULL;
+}
+
+const void* LinearStringmapViewGet(LinearStringmapView* view, char* key)
+{
+    return LinearStringmapViewGetN(view, key, (uint32_t)strlen(key));
+}
+
+int LinearStringmapViewContains(LinearStringmapView* view, char* key)
+{
+    return LinearStringmapViewGet(view, key) != NULL;
+}
+
+int LinearStringmapViewContainsN(LinearStringmapView* view, const char* key, uint32_t len)
+{
+    return LinearStringmapViewGetN(view, key, len) != NULL;
+}
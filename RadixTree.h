@@ -0,0 +1,695 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Adaptive radix tree over string keys (Leis et al., "The Adaptive Radix Tree").
+// Inner nodes grow 4 -> 16 -> 48 -> 256 children as they fill. Chains of
+// single-child nodes are collapsed into a prefix on the next node; only the
+// first RADIX_MAX_PREFIX bytes are kept and the rest is checked against a leaf.
+// Keys are stored with their NUL terminator so no key is a prefix of another,
+// and children are kept in byte order so walks return keys sorted.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Stringmap.h"
+#include "LinearStringmap.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define RADIX_MAX_PREFIX 8
+
+enum { RADIX_NODE4 = 1, RADIX_NODE16 = 2, RADIX_NODE48 = 3, RADIX_NODE256 = 4 };
+
+typedef struct RadixNode
+{
+    uint8_t type;
+    uint16_t numChildren;
+    uint32_t prefixLen;
+    uint8_t prefix[RADIX_MAX_PREFIX];
+} RadixNode;
+
+typedef struct RadixNode4
+{
+    RadixNode n;
+    uint8_t keys[4];
+    void* children[4];
+} RadixNode4;
+
+typedef struct RadixNode16
+{
+    RadixNode n;
+    uint8_t keys[16];
+    void* children[16];
+} RadixNode16;
+
+typedef struct RadixNode48
+{
+    RadixNode n;
+    uint8_t childIndex[256]; // slot + 1, 0 = no child
+    void* children[48];
+} RadixNode48;
+
+typedef struct RadixNode256
+{
+    RadixNode n;
+    void* children[256];
+} RadixNode256;
+
+// value (itemSize padded to 8) is followed by the key and its NUL
+typedef struct RadixLeaf
+{
+    uint32_t keyLen; // includes NUL
+    uint32_t pad;
+} RadixLeaf;
+
+typedef struct RadixTree
+{
+    void* root;
+    uint32_t itemSize;
+    uint32_t count;
+} RadixTree;
+
+// callback returns 0 to stop the walk
+typedef int (*RadixTreeCallback)(const char* key, uint32_t len, void* value, void* userData);
+
+// leaves are tagged with the low pointer bit
+static inline int RadixIsLeaf(void* p) { return ((uintptr_t)p & 1) != 0; }
+static inline RadixLeaf* RadixLeafPtr(void* p) { return (RadixLeaf*)((uintptr_t)p & ~(uintptr_t)1); }
+static inline void* RadixTagLeaf(RadixLeaf* leaf) { return (void*)((uintptr_t)leaf | 1); }
+
+static inline void* RadixLeafValue(RadixLeaf* leaf)
+{
+    return (char*)leaf + sizeof(RadixLeaf);
+}
+
+static inline uint8_t* RadixLeafKey(RadixTree* tree, RadixLeaf* leaf)
+{
+    return (uint8_t*)leaf + sizeof(RadixLeaf) + ((tree->itemSize + 7) & ~7u);
+}
+
+static inline uint32_t RadixMin(uint32_t a, uint32_t b)
+{
+    return a < b ? a : b;
+}
+
+void RadixTreeInit(RadixTree* tree, uint32_t itemSize)
+{
+    tree->root = NULL;
+    tree->itemSize = itemSize;
+    tree->count = 0;
+}
+
+static void RadixFreeNode(void* p)
+{
+    if (p == NULL) return;
+    if (RadixIsLeaf(p)) {
+        free(RadixLeafPtr(p));
+        return;
+    }
+    RadixNode* node = (RadixNode*)p;
+    switch (node->type) {
+        case RADIX_NODE4:
+            for (int i=0; i<node->numChildren; i++) RadixFreeNode(((RadixNode4*)node)->children[i]);
+            break;
+        case RADIX_NODE16:
+            for (int i=0; i<node->numChildren; i++) RadixFreeNode(((RadixNode16*)node)->children[i]);
+            break;
+        case RADIX_NODE48:
+            for (int i=0; i<48; i++) RadixFreeNode(((RadixNode48*)node)->children[i]);
+            break;
+        case RADIX_NODE256:
+            for (int i=0; i<256; i++) RadixFreeNode(((RadixNode256*)node)->children[i]);
+            break;
+    }
+    free(node);
+}
+
+void RadixTreeFree(RadixTree* tree)
+{
+    RadixFreeNode(tree->root);
+    tree->root = NULL;
+    tree->count = 0;
+}
+
+static RadixNode* RadixAllocNode(uint8_t type)
+{
+    size_t size;
+    switch (type) {
+        case RADIX_NODE4: size = sizeof(RadixNode4); break;
+        case RADIX_NODE16: size = sizeof(RadixNode16); break;
+        case RADIX_NODE48: size = sizeof(RadixNode48); break;
+        default: size = sizeof(RadixNode256); break;
+    }
+    RadixNode* node = (RadixNode*)calloc(1, size);
+    if (node) node->type = type;
+    return node;
+}
+
+static RadixLeaf* RadixMakeLeaf(RadixTree* tree, const uint8_t* key, uint32_t keyLen, void* value)
+{
+    RadixLeaf* leaf = (RadixLeaf*)malloc(sizeof(RadixLeaf) + ((tree->itemSize + 7) & ~7u) + keyLen);
+    if (leaf == NULL) return NULL;
+    leaf->keyLen = keyLen;
+    memcpy(RadixLeafValue(leaf), value, tree->itemSize);
+    memcpy(RadixLeafKey(tree, leaf), key, keyLen);
+    return leaf;
+}
+
+static inline int RadixCountTrailingZeros(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while ((x & 1) == 0) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+static void** RadixFindChild(RadixNode* node, uint8_t c)
+{
+    switch (node->type) {
+        case RADIX_NODE4: {
+            RadixNode4* n = (RadixNode4*)node;
+            for (int i=0; i<node->numChildren; i++) {
+                if (n->keys[i] == c) return &n->children[i];
+            }
+            return NULL;
+        }
+        case RADIX_NODE16: {
+            RadixNode16* n = (RadixNode16*)node;
+#if defined(__SSE2__)
+            __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)n->keys));
+            uint32_t bits = (uint32_t)_mm_movemask_epi8(cmp) & ((1u << node->numChildren) - 1);
+            if (bits) return &n->children[RadixCountTrailingZeros(bits)];
+#else
+            for (int i=0; i<node->numChildren; i++) {
+                if (n->keys[i] == c) return &n->children[i];
+            }
+#endif
+            return NULL;
+        }
+        case RADIX_NODE48: {
+            RadixNode48* n = (RadixNode48*)node;
+            uint8_t slot = n->childIndex[c];
+            return slot ? &n->children[slot - 1] : NULL;
+        }
+        case RADIX_NODE256: {
+            RadixNode256* n = (RadixNode256*)node;
+            return n->children[c] ? &n->children[c] : NULL;
+        }
+    }
+    return NULL;
+}
+
+static RadixLeaf* RadixMinimum(void* p)
+{
+    while (p && !RadixIsLeaf(p)) {
+        RadixNode* node = (RadixNode*)p;
+        switch (node->type) {
+            case RADIX_NODE4: p = ((RadixNode4*)node)->children[0]; break;
+            case RADIX_NODE16: p = ((RadixNode16*)node)->children[0]; break;
+            case RADIX_NODE48: {
+                RadixNode48* n = (RadixNode48*)node;
+                int c = 0;
+                while (!n->childIndex[c]) c++;
+                p = n->children[n->childIndex[c] - 1];
+                break;
+            }
+            case RADIX_NODE256: {
+                RadixNode256* n = (RadixNode256*)node;
+                int c = 0;
+                while (!n->children[c]) c++;
+                p = n->children[c];
+                break;
+            }
+        }
+    }
+    return p ? RadixLeafPtr(p) : NULL;
+}
+
+static void RadixCopyHeader(RadixNode* dst, RadixNode* src)
+{
+    dst->numChildren = src->numChildren;
+    dst->prefixLen = src->prefixLen;
+    memcpy(dst->prefix, src->prefix, RadixMin(RADIX_MAX_PREFIX, src->prefixLen));
+}
+
+static int RadixAddChild(RadixNode* node, void** ref, uint8_t c, void* child);
+
+static int RadixAddChild256(RadixNode256* n, uint8_t c, void* child)
+{
+    n->n.numChildren++;
+    n->children[c] = child;
+    return 1;
+}
+
+static int RadixAddChild48(RadixNode48* n, void** ref, uint8_t c, void* child)
+{
+    if (n->n.numChildren < 48) {
+        int pos = 0;
+        while (n->children[pos]) pos++;
+        n->children[pos] = child;
+        n->childIndex[c] = (uint8_t)(pos + 1);
+        n->n.numChildren++;
+        return 1;
+    }
+
+    // full -> grow to Node256
+    RadixNode256* grown = (RadixNode256*)RadixAllocNode(RADIX_NODE256);
+    if (grown == NULL) return 0;
+    for (int i=0; i<256; i++) {
+        if (n->childIndex[i]) grown->children[i] = n->children[n->childIndex[i] - 1];
+    }
+    RadixCopyHeader(&grown->n, &n->n);
+    *ref = grown;
+    free(n);
+    return RadixAddChild256(grown, c, child);
+}
+
+static int RadixAddChild16(RadixNode16* n, void** ref, uint8_t c, void* child)
+{
+    if (n->n.numChildren < 16) {
+        int pos = 0;
+        while (pos < n->n.numChildren && n->keys[pos] < c) pos++;
+        memmove(n->keys + pos + 1, n->keys + pos, n->n.numChildren - pos);
+        memmove(n->children + pos + 1, n->children + pos, (n->n.numChildren - pos) * sizeof(void*));
+        n->keys[pos] = c;
+        n->children[pos] = child;
+        n->n.numChildren++;
+        return 1;
+    }
+
+    // full -> grow to Node48
+    RadixNode48* grown = (RadixNode48*)RadixAllocNode(RADIX_NODE48);
+    if (grown == NULL) return 0;
+    for (int i=0; i<16; i++) {
+        grown->children[i] = n->children[i];
+        grown->childIndex[n->keys[i]] = (uint8_t)(i + 1);
+    }
+    RadixCopyHeader(&grown->n, &n->n);
+    *ref = grown;
+    free(n);
+    return RadixAddChild48(grown, ref, c, child);
+}
+
+static int RadixAddChild4(RadixNode4* n, void** ref, uint8_t c, void* child)
+{
+    if (n->n.numChildren < 4) {
+        int pos = 0;
+        while (pos < n->n.numChildren && n->keys[pos] < c) pos++;
+        memmove(n->keys + pos + 1, n->keys + pos, n->n.numChildren - pos);
+        memmove(n->children + pos + 1, n->children + pos, (n->n.numChildren - pos) * sizeof(void*));
+        n->keys[pos] = c;
+        n->children[pos] = child;
+        n->n.numChildren++;
+        return 1;
+    }
+
+    // full -> grow to Node16
+    RadixNode16* grown = (RadixNode16*)RadixAllocNode(RADIX_NODE16);
+    if (grown == NULL) return 0;
+    memcpy(grown->keys, n->keys, 4);
+    memcpy(grown->children, n->children, 4 * sizeof(void*));
+    RadixCopyHeader(&grown->n, &n->n);
+    *ref = grown;
+    free(n);
+    return RadixAddChild16(grown, ref, c, child);
+}
+
+static int RadixAddChild(RadixNode* node, void** ref, uint8_t c, void* child)
+{
+    switch (node->type) {
+        case RADIX_NODE4: return RadixAddChild4((RadixNode4*)node, ref, c, child);
+        case RADIX_NODE16: return RadixAddChild16((RadixNode16*)node, ref, c, child);
+        case RADIX_NODE48: return RadixAddChild48((RadixNode48*)node, ref, c, child);
+        default: return RadixAddChild256((RadixNode256*)node, c, child);
+    }
+}
+
+// index of the first byte where key differs from the node prefix
+static uint32_t RadixPrefixMismatch(RadixTree* tree, RadixNode* node, const uint8_t* key, uint32_t keyLen, uint32_t depth)
+{
+    uint32_t maxCmp = RadixMin(RadixMin(RADIX_MAX_PREFIX, node->prefixLen), keyLen - depth);
+    uint32_t idx;
+    for (idx=0; idx<maxCmp; idx++) {
+        if (node->prefix[idx] != key[depth + idx]) return idx;
+    }
+
+    // prefix longer than stored -> compare against a leaf
+    if (node->prefixLen > RADIX_MAX_PREFIX) {
+        RadixLeaf* leaf = RadixMinimum(node);
+        uint8_t* leafKey = RadixLeafKey(tree, leaf);
+        maxCmp = RadixMin(node->prefixLen, RadixMin(leaf->keyLen, keyLen) - depth);
+        for (; idx<maxCmp; idx++) {
+            if (leafKey[depth + idx] != key[depth + idx]) return idx;
+        }
+    }
+    return idx;
+}
+
+static int RadixInsert(RadixTree* tree, void** ref, const uint8_t* key, uint32_t keyLen, uint32_t depth, void* value)
+{
+    void* p = *ref;
+
+    // empty -> place leaf
+    if (p == NULL) {
+        RadixLeaf* leaf = RadixMakeLeaf(tree, key, keyLen, value);
+        if (leaf == NULL) return 0;
+        *ref = RadixTagLeaf(leaf);
+        tree->count++;
+        return 1;
+    }
+
+    if (RadixIsLeaf(p)) {
+        RadixLeaf* existing = RadixLeafPtr(p);
+        uint8_t* existingKey = RadixLeafKey(tree, existing);
+
+        // same key -> update value
+        if (existing->keyLen == keyLen && memcmp(existingKey, key, keyLen) == 0) {
+            memcpy(RadixLeafValue(existing), value, tree->itemSize);
+            return 1;
+        }
+
+        // split leaf into a Node4 holding the common prefix
+        RadixLeaf* leaf = RadixMakeLeaf(tree, key, keyLen, value);
+        RadixNode* node = RadixAllocNode(RADIX_NODE4);
+        if (leaf == NULL || node == NULL) {
+            free(leaf);
+            free(node);
+            return 0;
+        }
+        uint32_t common = 0;
+        while (existingKey[depth + common] == key[depth + common]) common++;
+        node->prefixLen = common;
+        memcpy(node->prefix, key + depth, RadixMin(RADIX_MAX_PREFIX, common));
+        RadixAddChild4((RadixNode4*)node, NULL, existingKey[depth + common], p);
+        RadixAddChild4((RadixNode4*)node, NULL, key[depth + common], RadixTagLeaf(leaf));
+        *ref = node;
+        tree->count++;
+        return 1;
+    }
+
+    RadixNode* node = (RadixNode*)p;
+    if (node->prefixLen) {
+        uint32_t diff = RadixPrefixMismatch(tree, node, key, keyLen, depth);
+
+        // key leaves the prefix early -> split prefix
+        if (diff < node->prefixLen) {
+            RadixLeaf* leaf = RadixMakeLeaf(tree, key, keyLen, value);
+            RadixNode* parent = RadixAllocNode(RADIX_NODE4);
+            if (leaf == NULL || parent == NULL) {
+                free(leaf);
+                free(parent);
+                return 0;
+            }
+            parent->prefixLen = diff;
+            memcpy(parent->prefix, node->prefix, RadixMin(RADIX_MAX_PREFIX, diff));
+
+            // shorten old prefix past the split byte
+            if (node->prefixLen <= RADIX_MAX_PREFIX) {
+                RadixAddChild4((RadixNode4*)parent, NULL, node->prefix[diff], node);
+                node->prefixLen -= diff + 1;
+                memmove(node->prefix, node->prefix + diff + 1, RadixMin(RADIX_MAX_PREFIX, node->prefixLen));
+            }
+            else
+            {
+                RadixLeaf* min = RadixMinimum(node);
+                uint8_t* minKey = RadixLeafKey(tree, min);
+                RadixAddChild4((RadixNode4*)parent, NULL, minKey[depth + diff], node);
+                node->prefixLen -= diff + 1;
+                memcpy(node->prefix, minKey + depth + diff + 1, RadixMin(RADIX_MAX_PREFIX, node->prefixLen));
+            }
+            RadixAddChild4((RadixNode4*)parent, NULL, key[depth + diff], RadixTagLeaf(leaf));
+            *ref = parent;
+            tree->count++;
+            return 1;
+        }
+        depth += node->prefixLen;
+    }
+
+    // descend or add a new leaf child
+    void** child = RadixFindChild(node, key[depth]);
+    if (child) return RadixInsert(tree, child, key, keyLen, depth + 1, value);
+
+    RadixLeaf* leaf = RadixMakeLeaf(tree, key, keyLen, value);
+    if (leaf == NULL) return 0;
+    if (!RadixAddChild(node, ref, key[depth], RadixTagLeaf(leaf))) {
+        free(leaf);
+        return 0;
+    }
+    tree->count++;
+    return 1;
+}
+
+// key is len bytes without NUL terminator; keys may not contain NUL bytes
+int RadixTreeSetN(RadixTree* tree, const char* key, uint32_t len, void* value)
+{
+    // copy so the NUL terminator is part of the key
+    uint8_t stackKey[256];
+    uint8_t* fullKey = len < sizeof(stackKey) ? stackKey : (uint8_t*)malloc(len + 1);
+    if (fullKey == NULL) return 0;
+    memcpy(fullKey, key, len);
+    fullKey[len] = '\0';
+    int result = RadixInsert(tree, &tree->root, fullKey, len + 1, 0, value);
+    if (fullKey != stackKey) free(fullKey);
+    return result;
+}
+
+int RadixTreeSet(RadixTree* tree, char* key, void* value)
+{
+    return RadixInsert(tree, &tree->root, (const uint8_t*)key, (uint32_t)strlen(key) + 1, 0, value);
+}
+
+void* RadixTreeGetN(RadixTree* tree, const char* key, uint32_t len)
+{
+    const uint8_t* k = (const uint8_t*)key;
+    void* p = tree->root;
+    uint32_t depth = 0;
+    while (p) {
+        if (RadixIsLeaf(p)) {
+            RadixLeaf* leaf = RadixLeafPtr(p);
+            if (leaf->keyLen == len + 1 && memcmp(RadixLeafKey(tree, leaf), key, len) == 0) {
+                return RadixLeafValue(leaf);
+            }
+            return NULL;
+        }
+        RadixNode* node = (RadixNode*)p;
+
+        // check stored prefix bytes, the leaf compare covers the rest
+        if (node->prefixLen) {
+            uint32_t check = RadixMin(RADIX_MAX_PREFIX, node->prefixLen);
+            for (uint32_t i=0; i<check; i++) {
+                if (depth + i >= len || node->prefix[i] != k[depth + i]) return NULL;
+            }
+            depth += node->prefixLen;
+        }
+        if (depth > len) return NULL;
+        uint8_t c = depth < len ? k[depth] : 0;
+        void** child = RadixFindChild(node, c);
+        p = child ? *child : NULL;
+        depth++;
+    }
+    return NULL;
+}
+
+void* RadixTreeGet(RadixTree* tree, char* key)
+{
+    return RadixTreeGetN(tree, key, (uint32_t)strlen(key));
+}
+
+int RadixTreeContains(RadixTree* tree, char* key)
+{
+    return RadixTreeGet(tree, key) != NULL;
+}
+
+// compare NUL terminated key bytes
+static inline int RadixCompareKeys(const uint8_t* a, uint32_t aLen, const uint8_t* b, uint32_t bLen)
+{
+    int cmp = memcmp(a, b, RadixMin(aLen, bLen));
+    if (cmp != 0) return cmp;
+    return (aLen > bLen) - (aLen < bLen);
+}
+
+// bounds of an ordered walk; lo/hi include their NUL, NULL = unbounded
+typedef struct RadixWalkState
+{
+    RadixTree* tree;
+    const uint8_t* lo;
+    uint32_t loLen;
+    const uint8_t* hi; // exclusive
+    uint32_t hiLen;
+    uint32_t prefixLen; // stop at the first key not starting with lo[0..prefixLen)
+    RadixTreeCallback fn;
+    void* userData;
+} RadixWalkState;
+
+enum { RADIX_WALK_SKIP = 0, RADIX_WALK_CONTINUE = 1, RADIX_WALK_STOP = 2 };
+
+// narrow the bounds by one key byte; loActive/hiActive mean the path so far
+// equals that bound
+static int RadixWalkByte(RadixWalkState* s, uint32_t depth, uint8_t c, int* loActive, int* hiActive)
+{
+    if (*loActive) {
+        uint8_t b = depth < s->loLen ? s->lo[depth] : 0;
+        if (c < b) return RADIX_WALK_SKIP;
+        if (c > b) *loActive = 0;
+    }
+    if (*hiActive) {
+        uint8_t b = depth < s->hiLen ? s->hi[depth] : 0;
+        if (c > b) return RADIX_WALK_STOP;
+        if (c < b) *hiActive = 0;
+    }
+    return RADIX_WALK_CONTINUE;
+}
+
+static int RadixWalk(RadixWalkState* s, void* p, uint32_t depth, int loActive, int hiActive)
+{
+    if (RadixIsLeaf(p)) {
+        RadixLeaf* leaf = RadixLeafPtr(p);
+        uint8_t* key = RadixLeafKey(s->tree, leaf);
+        if (s->lo && RadixCompareKeys(key, leaf->keyLen, s->lo, s->loLen) < 0) return RADIX_WALK_CONTINUE;
+        if (s->prefixLen && (leaf->keyLen <= s->prefixLen || memcmp(key, s->lo, s->prefixLen) != 0)) return RADIX_WALK_STOP;
+        if (s->hi && RadixCompareKeys(key, leaf->keyLen, s->hi, s->hiLen) >= 0) return RADIX_WALK_STOP;
+        if (!s->fn((const char*)key, leaf->keyLen - 1, RadixLeafValue(leaf), s->userData)) return RADIX_WALK_STOP;
+        return RADIX_WALK_CONTINUE;
+    }
+
+    // prefix bytes past RADIX_MAX_PREFIX come from a leaf
+    RadixNode* node = (RadixNode*)p;
+    if (node->prefixLen && (loActive || hiActive)) {
+        const uint8_t* prefix = node->prefix;
+        if (node->prefixLen > RADIX_MAX_PREFIX) {
+            prefix = RadixLeafKey(s->tree, RadixMinimum(node)) + depth;
+        }
+        for (uint32_t i=0; i<node->prefixLen && (loActive || hiActive); i++) {
+            int step = RadixWalkByte(s, depth + i, prefix[i], &loActive, &hiActive);
+            if (step != RADIX_WALK_CONTINUE) return step == RADIX_WALK_STOP ? RADIX_WALK_STOP : RADIX_WALK_CONTINUE;
+        }
+    }
+    depth += node->prefixLen;
+
+    // visit children in byte order
+    for (int c=0; c<256; c++) {
+        void* child = NULL;
+        switch (node->type) {
+            case RADIX_NODE4:
+            case RADIX_NODE16: {
+                uint8_t* keys = node->type == RADIX_NODE4 ? ((RadixNode4*)node)->keys : ((RadixNode16*)node)->keys;
+                void** children = node->type == RADIX_NODE4 ? ((RadixNode4*)node)->children : ((RadixNode16*)node)->children;
+                if (c >= node->numChildren) return RADIX_WALK_CONTINUE;
+                child = children[c];
+                int childLo = loActive, childHi = hiActive;
+                int step = RadixWalkByte(s, depth, keys[c], &childLo, &childHi);
+                if (step == RADIX_WALK_STOP) return RADIX_WALK_STOP;
+                if (step == RADIX_WALK_SKIP) continue;
+                if (RadixWalk(s, child, depth + 1, childLo, childHi) == RADIX_WALK_STOP) return RADIX_WALK_STOP;
+                continue;
+            }
+            case RADIX_NODE48: {
+                RadixNode48* n = (RadixNode48*)node;
+                if (n->childIndex[c]) child = n->children[n->childIndex[c] - 1];
+                break;
+            }
+            case RADIX_NODE256:
+                child = ((RadixNode256*)node)->children[c];
+                break;
+        }
+        if (child == NULL) continue;
+        int childLo = loActive, childHi = hiActive;
+        int step = RadixWalkByte(s, depth, (uint8_t)c, &childLo, &childHi);
+        if (step == RADIX_WALK_STOP) return RADIX_WALK_STOP;
+        if (step == RADIX_WALK_SKIP) continue;
+        if (RadixWalk(s, child, depth + 1, childLo, childHi) == RADIX_WALK_STOP) return RADIX_WALK_STOP;
+    }
+    return RADIX_WALK_CONTINUE;
+}
+
+// calls fn for every key in [lo, hi) in order; NULL lo/hi = unbounded
+void RadixTreeRangeEach(RadixTree* tree, char* lo, char* hi, RadixTreeCallback fn, void* userData)
+{
+    if (tree->root == NULL) return;
+    RadixWalkState s;
+    s.tree = tree;
+    s.lo = (const uint8_t*)lo;
+    s.loLen = lo ? (uint32_t)strlen(lo) + 1 : 0;
+    s.hi = (const uint8_t*)hi;
+    s.hiLen = hi ? (uint32_t)strlen(hi) + 1 : 0;
+    s.prefixLen = 0;
+    s.fn = fn;
+    s.userData = userData;
+    RadixWalk(&s, tree->root, 0, lo != NULL, hi != NULL);
+}
+
+// calls fn for every key starting with prefix, in order
+void RadixTreePrefixEachN(RadixTree* tree, const char* prefix, uint32_t len, RadixTreeCallback fn, void* userData)
+{
+    if (tree->root == NULL) return;
+
+    // walk from lo = prefix until the first key without it
+    RadixWalkState s;
+    s.tree = tree;
+    s.lo = (const uint8_t*)prefix;
+    s.loLen = len;
+    s.hi = NULL;
+    s.hiLen = 0;
+    s.prefixLen = len;
+    s.fn = fn;
+    s.userData = userData;
+    RadixWalk(&s, tree->root, 0, len != 0, 0);
+}
+
+void RadixTreePrefixEach(RadixTree* tree, char* prefix, RadixTreeCallback fn, void* userData)
+{
+    RadixTreePrefixEachN(tree, prefix, (uint32_t)strlen(prefix), fn, userData);
+}
+
+int RadixTreeFromStringmap(RadixTree* tree, Stringmap* map)
+{
+    RadixTreeInit(tree, map->itemSize);
+    StringmapIterator it = StringmapCreateIterator(map);
+    char* key;
+    void* value;
+    while (StringmapIteratorNext(&it, &key, &value)) {
+        if (!RadixTreeSet(tree, key, value)) {
+            RadixTreeFree(tree);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int RadixTreeFromLinearStringmap(RadixTree* tree, LinearStringmap* map)
+{
+    RadixTreeInit(tree, map->itemSize);
+    LinearStringmapIterator it = LinearStringmapCreateIterator(map);
+    char* key;
+    void* value;
+    while (LinearStringmapIteratorNext(&it, &key, &value)) {
+        if (!RadixTreeSet(tree, key, value)) {
+            RadixTreeFree(tree);
+            return 0;
+        }
+    }
+    return 1;
+}
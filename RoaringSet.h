@@ -0,0 +1,819 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compressed set of uint32 values (roaring bitmap layout).
+// Values are grouped by their high 16 bits into containers. Each container
+// stores the low 16 bits as either:
+//   array  - sorted uint16 values, up to 4096 of them
+//   bitmap - 65536 bits
+//   run    - sorted [start, start + length] ranges (via RoaringSetRunOptimize)
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_BITMAP_WORDS 1024
+
+enum { ROARING_ARRAY = 0, ROARING_BITMAP = 1, ROARING_RUN = 2 };
+
+typedef struct RoaringRun
+{
+    uint16_t start;
+    uint16_t length; // run covers start .. start + length
+} RoaringRun;
+
+typedef struct RoaringContainer
+{
+    void* data;           // uint16_t values | uint64_t words | RoaringRun runs
+    uint32_t cardinality;
+    uint32_t size;        // array values or runs in use
+    uint32_t capacity;    // array values or runs allocated
+    uint16_t key;         // high 16 bits
+    uint8_t type;
+} RoaringContainer;
+
+typedef struct RoaringSet
+{
+    RoaringContainer* containers; // sorted by key
+    uint32_t size;
+    uint32_t capacity;
+} RoaringSet;
+
+typedef struct RoaringSetIterator
+{
+    RoaringSet* set;
+    uint64_t bits;
+    uint32_t container;
+    uint32_t index;  // array value, bitmap word or run index
+    uint32_t offset; // position inside the current run
+} RoaringSetIterator;
+
+static inline uint32_t RoaringPopcount(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (uint32_t)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+static inline uint32_t RoaringCountTrailingZeros(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+// ------------------------------------------------------
+// --- Containers ---
+// ------------------------------------------------------
+
+static void RoaringContainerFree(RoaringContainer* c)
+{
+    free(c->data);
+    c->data = NULL;
+    c->cardinality = 0;
+    c->size = 0;
+    c->capacity = 0;
+}
+
+static int RoaringContainerInitArray(RoaringContainer* c, uint16_t key, uint32_t capacity)
+{
+    if (capacity < 4) capacity = 4;
+    c->data = malloc(capacity * sizeof(uint16_t));
+    if (c->data == NULL) return 0;
+    c->type = ROARING_ARRAY;
+    c->key = key;
+    c->cardinality = 0;
+    c->size = 0;
+    c->capacity = capacity;
+    return 1;
+}
+
+static int RoaringContainerInitBitmap(RoaringContainer* c, uint16_t key)
+{
+    c->data = calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+    if (c->data == NULL) return 0;
+    c->type = ROARING_BITMAP;
+    c->key = key;
+    c->cardinality = 0;
+    c->size = 0;
+    c->capacity = 0;
+    return 1;
+}
+
+// index of x, or -(insert position + 1)
+static int32_t RoaringArraySearch(const uint16_t* values, uint32_t size, uint16_t x)
+{
+    int32_t lo = 0;
+    int32_t hi = (int32_t)size - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (values[mid] < x) lo = mid + 1;
+        else if (values[mid] > x) hi = mid - 1;
+        else return mid;
+    }
+    return -(lo + 1);
+}
+
+static int RoaringRunContains(const RoaringContainer* c, uint16_t x)
+{
+    const RoaringRun* runs = (const RoaringRun*)c->data;
+    int32_t lo = 0;
+    int32_t hi = (int32_t)c->size - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        if (runs[mid].start > x) hi = mid - 1;
+        else if ((uint32_t)runs[mid].start + runs[mid].length < x) lo = mid + 1;
+        else return 1;
+    }
+    return 0;
+}
+
+static int RoaringContainerToBitmap(RoaringContainer* c)
+{
+    uint64_t* words = (uint64_t*)calloc(ROARING_BITMAP_WORDS, sizeof(uint64_t));
+    if (words == NULL) return 0;
+
+    if (c->type == ROARING_ARRAY) {
+        uint16_t* values = (uint16_t*)c->data;
+        for (uint32_t k=0; k<c->size; k++) {
+            words[values[k] >> 6] |= 1ull << (values[k] & 63);
+        }
+    }
+    else if (c->type == ROARING_RUN) {
+        RoaringRun* runs = (RoaringRun*)c->data;
+        for (uint32_t r=0; r<c->size; r++) {
+            uint32_t end = (uint32_t)runs[r].start + runs[r].length;
+            for (uint32_t v=runs[r].start; v<=end; v++) {
+                words[v >> 6] |= 1ull << (v & 63);
+            }
+        }
+    }
+    else {
+        free(words);
+        return 1;
+    }
+
+    free(c->data);
+    c->data = words;
+    c->type = ROARING_BITMAP;
+    c->size = 0;
+    c->capacity = 0;
+    return 1;
+}
+
+static int RoaringContainerToArray(RoaringContainer* c)
+{
+    if (c->type == ROARING_ARRAY) return 1;
+    uint32_t capacity = c->cardinality < 4 ? 4 : c->cardinality;
+    uint16_t* values = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+    if (values == NULL) return 0;
+
+    uint32_t n = 0;
+    if (c->type == ROARING_BITMAP) {
+        uint64_t* words = (uint64_t*)c->data;
+        for (uint32_t w=0; w<ROARING_BITMAP_WORDS; w++) {
+            uint64_t bits = words[w];
+            while (bits) {
+                values[n++] = (uint16_t)((w << 6) + RoaringCountTrailingZeros(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+    else {
+        RoaringRun* runs = (RoaringRun*)c->data;
+        for (uint32_t r=0; r<c->size; r++) {
+            uint32_t end = (uint32_t)runs[r].start + runs[r].length;
+            for (uint32_t v=runs[r].start; v<=end; v++) values[n++] = (uint16_t)v;
+        }
+    }
+
+    free(c->data);
+    c->data = values;
+    c->type = ROARING_ARRAY;
+    c->size = n;
+    c->capacity = capacity;
+    return 1;
+}
+
+// run containers are immutable; expand them before modification
+static int RoaringContainerUnrun(RoaringContainer* c)
+{
+    if (c->type != ROARING_RUN) return 1;
+    if (c->cardinality <= ROARING_ARRAY_MAX) return RoaringContainerToArray(c);
+    return RoaringContainerToBitmap(c);
+}
+
+static uint32_t RoaringContainerRunCount(const RoaringContainer* c)
+{
+    if (c->type == ROARING_RUN) return c->size;
+    if (c->type == ROARING_ARRAY) {
+        const uint16_t* values = (const uint16_t*)c->data;
+        uint32_t runs = c->size > 0;
+        for (uint32_t k=1; k<c->size; k++) {
+            runs += values[k] != values[k - 1] + 1;
+        }
+        return runs;
+    }
+
+    // run starts are set bits whose lower neighbour is clear
+    const uint64_t* words = (const uint64_t*)c->data;
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (uint32_t w=0; w<ROARING_BITMAP_WORDS; w++) {
+        runs += RoaringPopcount(words[w] & ~((words[w] << 1) | carry));
+        carry = words[w] >> 63;
+    }
+    return runs;
+}
+
+static int RoaringContainerToRun(RoaringContainer* c, uint32_t runCount)
+{
+    RoaringRun* runs = (RoaringRun*)malloc((runCount ? runCount : 1) * sizeof(RoaringRun));
+    if (runs == NULL) return 0;
+
+    uint32_t n = 0;
+    int32_t start = -1;
+    int32_t prev = -2;
+    if (c->type == ROARING_ARRAY) {
+        uint16_t* values = (uint16_t*)c->data;
+        for (uint32_t k=0; k<c->size; k++) {
+            if ((int32_t)values[k] != prev + 1) {
+                if (start >= 0) { runs[n].start = (uint16_t)start; runs[n].length = (uint16_t)(prev - start); n++; }
+                start = values[k];
+            }
+            prev = values[k];
+        }
+    }
+    else {
+        uint64_t* words = (uint64_t*)c->data;
+        for (uint32_t w=0; w<ROARING_BITMAP_WORDS; w++) {
+            uint64_t bits = words[w];
+            while (bits) {
+                int32_t v = (int32_t)((w << 6) + RoaringCountTrailingZeros(bits));
+                bits &= bits - 1;
+                if (v != prev + 1) {
+                    if (start >= 0) { runs[n].start = (uint16_t)start; runs[n].length = (uint16_t)(prev - start); n++; }
+                    start = v;
+                }
+                prev = v;
+            }
+        }
+    }
+    if (start >= 0) { runs[n].start = (uint16_t)start; runs[n].length = (uint16_t)(prev - start); n++; }
+
+    free(c->data);
+    c->data = runs;
+    c->type = ROARING_RUN;
+    c->size = n;
+    c->capacity = runCount;
+    return 1;
+}
+
+// returns 1 if x was added
+static int RoaringContainerAdd(RoaringContainer* c, uint16_t x)
+{
+    if (!RoaringContainerUnrun(c)) return 0;
+
+    if (c->type == ROARING_BITMAP) {
+        uint64_t* word = (uint64_t*)c->data + (x >> 6);
+        uint64_t mask = 1ull << (x & 63);
+        if (*word & mask) return 0;
+        *word |= mask;
+        c->cardinality++;
+        return 1;
+    }
+
+    uint16_t* values = (uint16_t*)c->data;
+    int32_t pos = RoaringArraySearch(values, c->size, x);
+    if (pos >= 0) return 0;
+    pos = -pos - 1;
+
+    // full array -> switch to bitmap
+    if (c->size == ROARING_ARRAY_MAX) {
+        if (!RoaringContainerToBitmap(c)) return 0;
+        return RoaringContainerAdd(c, x);
+    }
+    if (c->size == c->capacity) {
+        uint32_t capacity = c->capacity * 2;
+        if (capacity > ROARING_ARRAY_MAX) capacity = ROARING_ARRAY_MAX;
+        values = (uint16_t*)realloc(values, capacity * sizeof(uint16_t));
+        if (values == NULL) return 0;
+        c->data = values;
+        c->capacity = capacity;
+    }
+    memmove(values + pos + 1, values + pos, (c->size - pos) * sizeof(uint16_t));
+    values[pos] = x;
+    c->size++;
+    c->cardinality++;
+    return 1;
+}
+
+// returns 1 if x was removed
+static int RoaringContainerRemove(RoaringContainer* c, uint16_t x)
+{
+    if (!RoaringContainerUnrun(c)) return 0;
+
+    if (c->type == ROARING_BITMAP) {
+        uint64_t* word = (uint64_t*)c->data + (x >> 6);
+        uint64_t mask = 1ull << (x & 63);
+        if ((*word & mask) == 0) return 0;
+        *word &= ~mask;
+        c->cardinality--;
+        if (c->cardinality <= ROARING_ARRAY_MAX) RoaringContainerToArray(c);
+        return 1;
+    }
+
+    uint16_t* values = (uint16_t*)c->data;
+    int32_t pos = RoaringArraySearch(values, c->size, x);
+    if (pos < 0) return 0;
+    memmove(values + pos, values + pos + 1, (c->size - pos - 1) * sizeof(uint16_t));
+    c->size--;
+    c->cardinality--;
+    return 1;
+}
+
+static int RoaringContainerContains(const RoaringContainer* c, uint16_t x)
+{
+    if (c->type == ROARING_BITMAP) {
+        return (((const uint64_t*)c->data)[x >> 6] >> (x & 63)) & 1;
+    }
+    if (c->type == ROARING_RUN) {
+        return RoaringRunContains(c, x);
+    }
+    return RoaringArraySearch((const uint16_t*)c->data, c->size, x) >= 0;
+}
+
+// ------------------------------------------------------
+// --- Set ---
+// ------------------------------------------------------
+
+int RoaringSetInit(RoaringSet* set)
+{
+    set->capacity = 4;
+    set->size = 0;
+    set->containers = (RoaringContainer*)malloc(set->capacity * sizeof(RoaringContainer));
+    return set->containers != NULL;
+}
+
+void RoaringSetFree(RoaringSet* set)
+{
+    if (set->containers) {
+        for (uint32_t i=0; i<set->size; i++) RoaringContainerFree(&set->containers[i]);
+        free(set->containers);
+    }
+    set->containers = NULL;
+    set->size = 0;
+    set->capacity = 0;
+}
+
+void RoaringSetClear(RoaringSet* set)
+{
+    for (uint32_t i=0; i<set->size; i++) RoaringContainerFree(&set->containers[i]);
+    set->size = 0;
+}
+
+// index of container with key, or -(insert position + 1)
+static int32_t RoaringSetFindContainer(const RoaringSet* set, uint16_t key)
+{
+    int32_t lo = 0;
+    int32_t hi = (int32_t)set->size - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) >> 1;
+        uint16_t midKey = set->containers[mid].key;
+        if (midKey < key) lo = mid + 1;
+        else if (midKey > key) hi = mid - 1;
+        else return mid;
+    }
+    return -(lo + 1);
+}
+
+static RoaringContainer* RoaringSetInsertContainer(RoaringSet* set, uint32_t pos)
+{
+    if (set->size == set->capacity) {
+        uint32_t capacity = set->capacity ? set->capacity * 2 : 4;
+        RoaringContainer* containers = (RoaringContainer*)realloc(set->containers, capacity * sizeof(RoaringContainer));
+        if (containers == NULL) return NULL;
+        set->containers = containers;
+        set->capacity = capacity;
+    }
+    memmove(set->containers + pos + 1, set->containers + pos, (set->size - pos) * sizeof(RoaringContainer));
+    set->size++;
+    return &set->containers[pos];
+}
+
+static void RoaringSetRemoveContainer(RoaringSet* set, uint32_t pos)
+{
+    RoaringContainerFree(&set->containers[pos]);
+    memmove(set->containers + pos, set->containers + pos + 1, (set->size - pos - 1) * sizeof(RoaringContainer));
+    set->size--;
+}
+
+// returns 1 if x was added
+int RoaringSetAdd(RoaringSet* set, uint32_t x)
+{
+    uint16_t key = (uint16_t)(x >> 16);
+    int32_t pos = RoaringSetFindContainer(set, key);
+    if (pos < 0) {
+        pos = -pos - 1;
+        RoaringContainer* c = RoaringSetInsertContainer(set, (uint32_t)pos);
+        if (c == NULL) return 0;
+        if (!RoaringContainerInitArray(c, key, 4)) {
+            memmove(set->containers + pos, set->containers + pos + 1, (set->size - pos - 1) * sizeof(RoaringContainer));
+            set->size--;
+            return 0;
+        }
+    }
+    return RoaringContainerAdd(&set->containers[pos], (uint16_t)x);
+}
+
+// returns 1 if x was removed
+int RoaringSetRemove(RoaringSet* set, uint32_t x)
+{
+    int32_t pos = RoaringSetFindContainer(set, (uint16_t)(x >> 16));
+    if (pos < 0) return 0;
+    RoaringContainer* c = &set->containers[pos];
+    if (!RoaringContainerRemove(c, (uint16_t)x)) return 0;
+    if (c->cardinality == 0) RoaringSetRemoveContainer(set, (uint32_t)pos);
+    return 1;
+}
+
+int RoaringSetContains(const RoaringSet* set, uint32_t x)
+{
+    int32_t pos = RoaringSetFindContainer(set, (uint16_t)(x >> 16));
+    if (pos < 0) return 0;
+    return RoaringContainerContains(&set->containers[pos], (uint16_t)x);
+}
+
+uint64_t RoaringSetCardinality(const RoaringSet* set)
+{
+    uint64_t cardinality = 0;
+    for (uint32_t i=0; i<set->size; i++) cardinality += set->containers[i].cardinality;
+    return cardinality;
+}
+
+// Converts each container to run form when that is smaller. Call after bulk
+// loading dense ranges.
+void RoaringSetRunOptimize(RoaringSet* set)
+{
+    for (uint32_t i=0; i<set->size; i++) {
+        RoaringContainer* c = &set->containers[i];
+        if (c->type == ROARING_RUN) continue;
+        uint32_t runs = RoaringContainerRunCount(c);
+        uint32_t currentBytes = c->type == ROARING_ARRAY ? c->cardinality * 2 : ROARING_BITMAP_WORDS * 8;
+        if (runs * sizeof(RoaringRun) < currentBytes) RoaringContainerToRun(c, runs);
+    }
+}
+
+size_t RoaringSetMemoryUsage(const RoaringSet* set)
+{
+    size_t bytes = sizeof(RoaringSet) + set->capacity * sizeof(RoaringContainer);
+    for (uint32_t i=0; i<set->size; i++) {
+        const RoaringContainer* c = &set->containers[i];
+        if (c->type == ROARING_BITMAP) bytes += ROARING_BITMAP_WORDS * sizeof(uint64_t);
+        else if (c->type == ROARING_RUN) bytes += c->capacity * sizeof(RoaringRun);
+        else bytes += c->capacity * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+// ------------------------------------------------------
+// --- Set Operations ---
+// ------------------------------------------------------
+
+// out = a & b or a | b over whole bitmaps; returns cardinality
+static uint32_t RoaringBitmapCombine(const uint64_t* a, const uint64_t* b, uint64_t* out, int isUnion)
+{
+    uint32_t cardinality = 0;
+#if defined(__SSE2__)
+    for (uint32_t w=0; w<ROARING_BITMAP_WORDS; w+=2) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + w));
+        __m128i y = _mm_loadu_si128((const __m128i*)(b + w));
+        __m128i r = isUnion ? _mm_or_si128(x, y) : _mm_and_si128(x, y);
+        _mm_storeu_si128((__m128i*)(out + w), r);
+        cardinality += RoaringPopcount(out[w]) + RoaringPopcount(out[w + 1]);
+    }
+#else
+    for (uint32_t w=0; w<ROARING_BITMAP_WORDS; w++) {
+        out[w] = isUnion ? (a[w] | b[w]) : (a[w] & b[w]);
+        cardinality += RoaringPopcount(out[w]);
+    }
+#endif
+    return cardinality;
+}
+
+// first index >= start where values[index] >= x (exponential then binary search)
+static uint32_t RoaringGallop(const uint16_t* values, uint32_t start, uint32_t size, uint16_t x)
+{
+    uint32_t step = 1;
+    uint32_t hi = start;
+    while (hi < size && values[hi] < x) {
+        start = hi + 1;
+        hi += step;
+        step <<= 1;
+    }
+    if (hi > size) hi = size;
+    while (start < hi) {
+        uint32_t mid = (start + hi) >> 1;
+        if (values[mid] < x) start = mid + 1;
+        else hi = mid;
+    }
+    return start;
+}
+
+static int RoaringContainerIntersect(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out)
+{
+    // array & anything -> filter the array
+    if (b->type == ROARING_ARRAY && a->type != ROARING_ARRAY) {
+        const RoaringContainer* swap = a; a = b; b = swap;
+    }
+    if (a->type == ROARING_ARRAY) {
+        if (!RoaringContainerInitArray(out, a->key, a->size)) return 0;
+        const uint16_t* x = (const uint16_t*)a->data;
+        uint16_t* values = (uint16_t*)out->data;
+        uint32_t n = 0;
+        if (b->type == ROARING_ARRAY) {
+            const uint16_t* y = (const uint16_t*)b->data;
+            const uint16_t* small = a->size <= b->size ? x : y;
+            const uint16_t* large = a->size <= b->size ? y : x;
+            uint32_t smallSize = a->size <= b->size ? a->size : b->size;
+            uint32_t largeSize = a->size <= b->size ? b->size : a->size;
+
+            if (smallSize * 32 < largeSize) { // skewed -> gallop through the large side
+                uint32_t j = 0;
+                for (uint32_t i=0; i<smallSize && j<largeSize; i++) {
+                    j = RoaringGallop(large, j, largeSize, small[i]);
+                    if (j < largeSize && large[j] == small[i]) values[n++] = small[i];
+                }
+            }
+            else { // merge
+                uint32_t i = 0, j = 0;
+                while (i < smallSize && j < largeSize) {
+                    if (small[i] < large[j]) i++;
+                    else if (small[i] > large[j]) j++;
+                    else { values[n++] = small[i]; i++; j++; }
+                }
+            }
+        }
+        else {
+            for (uint32_t i=0; i<a->size; i++) {
+                if (RoaringContainerContains(b, x[i])) values[n++] = x[i];
+            }
+        }
+        out->size = n;
+        out->cardinality = n;
+        return 1;
+    }
+
+    // bitmap & bitmap
+    if (!RoaringContainerInitBitmap(out, a->key)) return 0;
+    out->cardinality = RoaringBitmapCombine((const uint64_t*)a->data, (const uint64_t*)b->data, (uint64_t*)out->data, 0);
+    if (out->cardinality <= ROARING_ARRAY_MAX) RoaringContainerToArray(out); // stays a valid bitmap on failure
+    return 1;
+}
+
+static int RoaringContainerUnion(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out)
+{
+    // array | array small enough -> merge
+    if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY && a->size + b->size <= ROARING_ARRAY_MAX) {
+        if (!RoaringContainerInitArray(out, a->key, a->size + b->size)) return 0;
+        const uint16_t* x = (const uint16_t*)a->data;
+        const uint16_t* y = (const uint16_t*)b->data;
+        uint16_t* values = (uint16_t*)out->data;
+        uint32_t i = 0, j = 0, n = 0;
+        while (i < a->size && j < b->size) {
+            if (x[i] < y[j]) values[n++] = x[i++];
+            else if (x[i] > y[j]) values[n++] = y[j++];
+            else { values[n++] = x[i++]; j++; }
+        }
+        while (i < a->size) values[n++] = x[i++];
+        while (j < b->size) values[n++] = y[j++];
+        out->size = n;
+        out->cardinality = n;
+        return 1;
+    }
+
+    if (!RoaringContainerInitBitmap(out, a->key)) return 0;
+    uint64_t* words = (uint64_t*)out->data;
+    if (a->type == ROARING_BITMAP && b->type == ROARING_BITMAP) {
+        out->cardinality = RoaringBitmapCombine((const uint64_t*)a->data, (const uint64_t*)b->data, words, 1);
+        return 1;
+    }
+
+    // copy the bitmap side (if any) then set the array values
+    const RoaringContainer* bitmap = a->type == ROARING_BITMAP ? a : (b->type == ROARING_BITMAP ? b : NULL);
+    uint32_t cardinality = 0;
+    if (bitmap) {
+        memcpy(words, bitmap->data, ROARING_BITMAP_WORDS * sizeof(uint64_t));
+        cardinality = bitmap->cardinality;
+    }
+    const RoaringContainer* arrays[2] = { a, b };
+    for (uint32_t s=0; s<2; s++) {
+        if (arrays[s] == bitmap) continue;
+        const uint16_t* values = (const uint16_t*)arrays[s]->data;
+        for (uint32_t k=0; k<arrays[s]->size; k++) {
+            uint64_t mask = 1ull << (values[k] & 63);
+            uint64_t* word = &words[values[k] >> 6];
+            cardinality += (*word & mask) == 0;
+            *word |= mask;
+        }
+    }
+    out->cardinality = cardinality;
+    if (cardinality <= ROARING_ARRAY_MAX) RoaringContainerToArray(out); // stays a valid bitmap on failure
+    return 1;
+}
+
+// run operands are combined through a temporary bitmap
+static const RoaringContainer* RoaringContainerOperand(const RoaringContainer* c, RoaringContainer* tmp)
+{
+    if (c->type != ROARING_RUN) return c;
+    *tmp = *c;
+    tmp->data = malloc(c->capacity * sizeof(RoaringRun));
+    if (tmp->data == NULL) return NULL;
+    memcpy(tmp->data, c->data, c->size * sizeof(RoaringRun));
+    if (!RoaringContainerToBitmap(tmp)) {
+        RoaringContainerFree(tmp);
+        return NULL;
+    }
+    return tmp;
+}
+
+static int RoaringSetAppendCopy(RoaringSet* out, const RoaringContainer* c)
+{
+    RoaringContainer* dst = RoaringSetInsertContainer(out, out->size);
+    if (dst == NULL) return 0;
+    *dst = *c;
+    size_t bytes = c->type == ROARING_BITMAP ? ROARING_BITMAP_WORDS * sizeof(uint64_t)
+                 : c->type == ROARING_RUN ? c->capacity * sizeof(RoaringRun)
+                 : c->capacity * sizeof(uint16_t);
+    dst->data = malloc(bytes);
+    if (dst->data == NULL) { out->size--; return 0; }
+    memcpy(dst->data, c->data, bytes);
+    return 1;
+}
+
+// on failure out is freed, so callers never see a half built set
+static int RoaringSetCombine(const RoaringSet* a, const RoaringSet* b, RoaringSet* out, int isUnion)
+{
+    if (!RoaringSetInit(out)) return 0;
+    uint32_t i = 0, j = 0;
+    while (i < a->size || j < b->size) {
+        const RoaringContainer* ca = i < a->size ? &a->containers[i] : NULL;
+        const RoaringContainer* cb = j < b->size ? &b->containers[j] : NULL;
+
+        // key on one side only
+        if (cb == NULL || (ca != NULL && ca->key < cb->key)) {
+            if (isUnion && !RoaringSetAppendCopy(out, ca)) {
+                RoaringSetFree(out);
+                return 0;
+            }
+            i++;
+            continue;
+        }
+        if (ca == NULL || cb->key < ca->key) {
+            if (isUnion && !RoaringSetAppendCopy(out, cb)) {
+                RoaringSetFree(out);
+                return 0;
+            }
+            j++;
+            continue;
+        }
+
+        // same key -> combine containers
+        RoaringContainer tmpA, tmpB, result;
+        const RoaringContainer* x = RoaringContainerOperand(ca, &tmpA);
+        const RoaringContainer* y = RoaringContainerOperand(cb, &tmpB);
+        int ok = x && y && (isUnion ? RoaringContainerUnion(x, y, &result) : RoaringContainerIntersect(x, y, &result));
+        if (x && x != ca) RoaringContainerFree(&tmpA);
+        if (y && y != cb) RoaringContainerFree(&tmpB);
+        if (!ok) {
+            RoaringSetFree(out);
+            return 0;
+        }
+
+        if (result.cardinality == 0) RoaringContainerFree(&result);
+        else {
+            RoaringContainer* dst = RoaringSetInsertContainer(out, out->size);
+            if (dst == NULL) {
+                RoaringContainerFree(&result);
+                RoaringSetFree(out);
+                return 0;
+            }
+            *dst = result;
+        }
+        i++;
+        j++;
+    }
+    return 1;
+}
+
+// out must be uninitialised; returns 0 on allocation failure
+int RoaringSetUnion(const RoaringSet* a, const RoaringSet* b, RoaringSet* out)
+{
+    return RoaringSetCombine(a, b, out, 1);
+}
+
+int RoaringSetIntersect(const RoaringSet* a, const RoaringSet* b, RoaringSet* out)
+{
+    return RoaringSetCombine(a, b, out, 0);
+}
+
+// ------------------------------------------------------
+// --- Iteration (ascending order) ---
+// ------------------------------------------------------
+
+RoaringSetIterator RoaringSetCreateIterator(RoaringSet* set)
+{
+    RoaringSetIterator iterator;
+    iterator.set = set;
+    iterator.bits = 0;
+    iterator.container = 0;
+    iterator.index = 0;
+    iterator.offset = 0;
+    if (set->size > 0 && set->containers[0].type == ROARING_BITMAP) {
+        iterator.bits = ((uint64_t*)set->containers[0].data)[0];
+    }
+    return iterator;
+}
+
+int RoaringSetIteratorNext(RoaringSetIterator* it, uint32_t* valueOut)
+{
+    RoaringSet* set = it->set;
+    while (it->container < set->size) {
+        RoaringContainer* c = &set->containers[it->container];
+        uint32_t high = (uint32_t)c->key << 16;
+
+        if (c->type == ROARING_ARRAY) {
+            if (it->index < c->size) {
+                *valueOut = high | ((uint16_t*)c->data)[it->index++];
+                return 1;
+            }
+        }
+        else if (c->type == ROARING_BITMAP) {
+            uint64_t* words = (uint64_t*)c->data;
+            while (it->bits == 0 && ++it->index < ROARING_BITMAP_WORDS) {
+                it->bits = words[it->index];
+            }
+            if (it->bits) {
+                *valueOut = high | ((it->index << 6) + RoaringCountTrailingZeros(it->bits));
+                it->bits &= it->bits - 1;
+                return 1;
+            }
+        }
+        else {
+            RoaringRun* runs = (RoaringRun*)c->data;
+            if (it->index < c->size) {
+                *valueOut = high | (uint32_t)(runs[it->index].start + it->offset);
+                if (it->offset++ == runs[it->index].length) {
+                    it->index++;
+                    it->offset = 0;
+                }
+                return 1;
+            }
+        }
+
+        // next container
+        it->container++;
+        it->index = 0;
+        it->offset = 0;
+        it->bits = 0;
+        if (it->container < set->size && set->containers[it->container].type == ROARING_BITMAP) {
+            it->bits = ((uint64_t*)set->containers[it->container].data)[0];
+        }
+    }
+
+    // done -> reset
+    *it = RoaringSetCreateIterator(set);
+    return 0;
+}
@@ -23,6 +23,15 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include "DynamicArray.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SET_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define SET_PREFETCH(p) ((void)0)
+#endif
+
+#define SET_BATCH 16
 
 typedef struct Set
 {
@@ -34,6 +43,13 @@ typedef struct Set
     uint32_t maxProbes;
 } Set;
 
+typedef struct SetIterator
+{
+    Set* set;
+    uint64_t bits; // unvisited occupied slots of the current word
+    uint32_t word; // next 64 slot word to load
+} SetIterator;
+
 Set SetCreate(uint32_t itemSize, uint32_t capacity)
 {
     Set set;
@@ -159,6 +175,7 @@ void SetInsert(Set* set, void* item)
             // item already in set? update it
             if (memcmp(dst, item, set->itemSize) == 0) {
                 memcpy(dst, item, set->itemSize);
+                return;
             }
         }
         else {
@@ -229,6 +246,46 @@ void SetRemove(Set* set, void* item)
     set->count--;
 }
 
+// Removes every item for which keep() returns 0 in one pass over the table,
+// re-seating kept items behind each removal instead of shifting per item.
+uint32_t SetRetainIf(Set* set, int (*keep)(void* item, void* userData), void* userData)
+{
+    if (set->count == 0) return 0;
+
+    // start at an empty slot so no probe chain wraps past the scan start
+    uint32_t start = 0;
+    while (start < set->capacity && SetSlotOccupied(set, start)) start++;
+
+    uint32_t removed = 0;
+    int holeInRun = 0;
+    for (uint32_t n=1; n<=set->capacity; n++) {
+        uint32_t i = (start + n) % set->capacity;
+        if (!SetSlotOccupied(set, i)) { // end of probe run
+            holeInRun = 0;
+            continue;
+        }
+
+        char* item = (char*)set->data + i * set->itemSize;
+        if (!keep(item, userData)) {
+            SetFreeSlot(set, i);
+            removed++;
+            holeInRun = 1;
+            continue;
+        }
+        if (!holeInRun) continue;
+
+        // move item to the first free slot from its home
+        SetFreeSlot(set, i);
+        uint32_t j = SetHash(item, set->itemSize) % set->capacity;
+        while (SetSlotOccupied(set, j)) j = (j + 1) % set->capacity;
+        if (j != i) memcpy((char*)set->data + j * set->itemSize, item, set->itemSize);
+        SetMarkSlot(set, j);
+    }
+
+    set->count -= removed;
+    return removed;
+}
+
 int SetContains(Set* set, void* item)
 {
     uint32_t probes = 0;
@@ -256,4 +313,323 @@ void SetClear(Set* set)
     memset(set->occupancy, 0, occupancyBytes);
     set->count = 0;
     set->maxProbes = 0;
+}
+
+// occupancy bits [word * 64, word * 64 + 64) as one integer
+static inline uint64_t SetOccupancyWord(Set* set, uint32_t word)
+{
+    uint32_t occupancyBytes = (set->capacity + 7) >> 3;
+    uint32_t offset = word << 3;
+    uint32_t n = occupancyBytes - offset;
+    if (n > 8) n = 8;
+
+    uint64_t bits = 0;
+    for (uint32_t k=0; k<n; k++) {
+        bits |= (uint64_t)set->occupancy[offset + k] << (k << 3);
+    }
+    return bits;
+}
+
+static inline uint32_t SetCountTrailingZeros(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctzll(bits);
+#else
+    uint32_t n = 0;
+    while ((bits & 1) == 0) { bits >>= 1; n++; }
+    return n;
+#endif
+}
+
+SetIterator SetCreateIterator(Set* set)
+{
+    SetIterator iterator;
+    iterator.set = set;
+    iterator.bits = 0;
+    iterator.word = 0;
+    return iterator;
+}
+
+int SetIteratorNext(SetIterator* it, void** itemOut)
+{
+    Set* set = it->set;
+    uint32_t words = (set->capacity + 63) >> 6;
+
+    // skip empty words
+    while (it->bits == 0) {
+        if (it->word >= words) { // done -> reset
+            it->word = 0;
+            return 0;
+        }
+        it->bits = SetOccupancyWord(set, it->word++);
+    }
+
+    // take lowest occupied slot
+    uint32_t index = ((it->word - 1) << 6) + SetCountTrailingZeros(it->bits);
+    it->bits &= it->bits - 1;
+    *itemOut = (char*)set->data + index * set->itemSize;
+    return 1;
+}
+
+static inline uint64_t SetLoadUint(const char* item, uint32_t itemSize)
+{
+    switch (itemSize) {
+        case 1: return *(const uint8_t*)item;
+        case 2: { uint16_t v; memcpy(&v, item, 2); return v; }
+        case 4: { uint32_t v; memcpy(&v, item, 4); return v; }
+        default: { uint64_t v; memcpy(&v, item, 8); return v; }
+    }
+}
+
+// LSD radix sort of unsigned 1, 2, 4 or 8 byte integers
+static void SetRadixSort(char* items, char* tmp, uint32_t count, uint32_t itemSize)
+{
+    char* src = items;
+    char* dst = tmp;
+    for (uint32_t pass=0; pass<itemSize; pass++) {
+        uint32_t shift = pass << 3;
+        uint32_t counts[256] = {0};
+        for (uint32_t k=0; k<count; k++) {
+            counts[(SetLoadUint(src + k * itemSize, itemSize) >> shift) & 0xFF]++;
+        }
+
+        // every item shares this digit -> pass is a no-op
+        uint32_t skip = 0;
+        for (uint32_t d=0; d<256; d++) {
+            if (counts[d] == count) { skip = 1; break; }
+        }
+        if (skip) continue;
+
+        uint32_t offset = 0;
+        for (uint32_t d=0; d<256; d++) {
+            uint32_t c = counts[d];
+            counts[d] = offset;
+            offset += c;
+        }
+        for (uint32_t k=0; k<count; k++) {
+            uint32_t d = (SetLoadUint(src + k * itemSize, itemSize) >> shift) & 0xFF;
+            memcpy(dst + counts[d]++ * itemSize, src + k * itemSize, itemSize);
+        }
+        char* swap = src; src = dst; dst = swap;
+    }
+    if (src != items) memcpy(items, src, (size_t)count * itemSize);
+}
+
+// Appends every item to out (elementSize must equal itemSize). With sorted set,
+// 1/2/4/8 byte items are emitted in ascending unsigned integer order.
+int SetToArray(Set* set, DynamicArray* out, int sorted)
+{
+    if (out->elementSize != set->itemSize) return 0;
+
+    // sort scratch first so a failed malloc leaves out untouched
+    uint32_t itemSize = set->itemSize;
+    char* tmp = NULL;
+    if (sorted && set->count > 1 && (itemSize == 1 || itemSize == 2 || itemSize == 4 || itemSize == 8)) {
+        tmp = (char*)malloc((size_t)set->count * itemSize);
+        if (tmp == NULL) return 0;
+    }
+
+    // reserve once
+    uint32_t needed = out->size + set->count;
+    if (out->capacity < needed) {
+        void* data = realloc(out->data, (size_t)needed * out->elementSize);
+        if (data == NULL) { free(tmp); return 0; }
+        out->data = data;
+        out->capacity = needed;
+    }
+
+    char* base = (char*)out->data + (size_t)out->size * out->elementSize;
+    char* dst = base;
+    uint32_t words = (set->capacity + 63) >> 6;
+    for (uint32_t w=0; w<words; w++) {
+        uint64_t bits = SetOccupancyWord(set, w);
+        while (bits) {
+            uint32_t index = (w << 6) + SetCountTrailingZeros(bits);
+            bits &= bits - 1;
+            memcpy(dst, (char*)set->data + index * set->itemSize, set->itemSize);
+            dst += set->itemSize;
+        }
+    }
+    out->size += set->count;
+
+    if (tmp != NULL) {
+        SetRadixSort(base, tmp, set->count, itemSize);
+        free(tmp);
+    }
+    return 1;
+}
+
+Set SetCopy(Set* set)
+{
+    Set copy = *set;
+    uint32_t occupancyBytes = (set->capacity + 7) >> 3;
+    copy.occupancy = (uint8_t*)malloc(occupancyBytes);
+    copy.data = malloc(set->capacity * set->itemSize);
+    if (copy.occupancy == NULL || copy.data == NULL) {
+        // callers test data == NULL, so leave no dangling pointers behind
+        SetFree(&copy);
+        copy.occupancy = NULL;
+        copy.data = NULL;
+        return copy;
+    }
+    memcpy(copy.occupancy, set->occupancy, occupancyBytes);
+    memcpy(copy.data, set->data, set->capacity * set->itemSize);
+    return copy;
+}
+
+// ------------------------------------------------------
+// --- Set Algebra (both sets must share itemSize) ---
+// ------------------------------------------------------
+
+static inline int SetItemEquals(const void* a, const void* b, uint32_t itemSize)
+{
+    // fixed width ids -> single word compare
+    if (itemSize == 4) {
+        uint32_t x, y;
+        memcpy(&x, a, 4); memcpy(&y, b, 4);
+        return x == y;
+    }
+    if (itemSize == 8) {
+        uint64_t x, y;
+        memcpy(&x, a, 8); memcpy(&y, b, 8);
+        return x == y;
+    }
+    return memcmp(a, b, itemSize) == 0;
+}
+
+// hash and prefetch the home slots of a whole batch, then probe each item
+static void SetContainsBatch(Set* set, char** items, uint32_t n, uint8_t* found)
+{
+    uint32_t homes[SET_BATCH];
+    for (uint32_t k=0; k<n; k++) {
+        homes[k] = SetHash(items[k], set->itemSize) % set->capacity;
+        SET_PREFETCH(&set->occupancy[homes[k] >> 3]);
+        SET_PREFETCH((char*)set->data + homes[k] * set->itemSize);
+    }
+
+    for (uint32_t k=0; k<n; k++) {
+        found[k] = 0;
+        for (uint32_t probes=0; probes<set->maxProbes; probes++) {
+            uint32_t i = (homes[k] + probes) % set->capacity;
+            if (!SetSlotOccupied(set, i)) break;
+            if (SetItemEquals((char*)set->data + i * set->itemSize, items[k], set->itemSize)) {
+                found[k] = 1;
+                break;
+            }
+        }
+    }
+}
+
+// insert into out every item of src whose membership in probe equals wantFound
+static void SetProbeEach(Set* src, Set* probe, int wantFound, Set* out)
+{
+    char* items[SET_BATCH];
+    uint8_t found[SET_BATCH];
+    SetIterator it = SetCreateIterator(src);
+    int more = 1;
+    while (more) {
+        uint32_t n = 0;
+        void* item;
+        while (n < SET_BATCH && (more = SetIteratorNext(&it, &item))) {
+            items[n++] = (char*)item;
+        }
+        if (n == 0) break;
+
+        if (probe->count == 0) memset(found, 0, n);
+        else SetContainsBatch(probe, items, n, found);
+        for (uint32_t k=0; k<n; k++) {
+            if (found[k] == wantFound) SetInsert(out, items[k]);
+        }
+    }
+}
+
+static int SetContainedIn(void* item, void* userData)
+{
+    return SetContains((Set*)userData, item);
+}
+
+static int SetNotContainedIn(void* item, void* userData)
+{
+    return !SetContains((Set*)userData, item);
+}
+
+// capacity that holds count items below the resize threshold
+static inline uint32_t SetCapacityFor(uint32_t count)
+{
+    return (uint32_t)(count / 0.6) + 16;
+}
+
+Set SetUnion(Set* a, Set* b)
+{
+    Set* large = a->count >= b->count ? a : b;
+    Set* small = a->count >= b->count ? b : a;
+    Set out = SetCopy(large);
+    if (out.data == NULL) return out;
+    SetProbeEach(small, large, 0, &out);
+    return out;
+}
+
+Set SetIntersect(Set* a, Set* b)
+{
+    Set* large = a->count >= b->count ? a : b;
+    Set* small = a->count >= b->count ? b : a;
+    Set out = SetCreate(a->itemSize, SetCapacityFor(small->count));
+    SetProbeEach(small, large, 1, &out);
+    return out;
+}
+
+// a \ b
+Set SetDifference(Set* a, Set* b)
+{
+    // b much smaller -> copy a and remove b's items
+    if (b->count * 4 < a->count) {
+        Set out = SetCopy(a);
+        if (out.data == NULL) return out;
+        for (uint32_t i=0; i<b->capacity; i++) {
+            if (SetSlotOccupied(b, i)) SetRemove(&out, (char*)b->data + i * b->itemSize);
+        }
+        return out;
+    }
+
+    Set out = SetCreate(a->itemSize, SetCapacityFor(a->count));
+    SetProbeEach(a, b, 0, &out);
+    return out;
+}
+
+// a = a | b
+void SetUnionWith(Set* a, Set* b)
+{
+    // a | a == a, and inserting into a may resize it while b is iterated
+    if (a == b) return;
+    SetProbeEach(b, a, 0, a);
+}
+
+// a = a & b
+void SetIntersectWith(Set* a, Set* b)
+{
+    // b much smaller -> build from b instead of sweeping a
+    if (b->count * 4 < a->count) {
+        Set out = SetIntersect(a, b);
+        SetFree(a);
+        *a = out;
+        return;
+    }
+    SetRetainIf(a, SetContainedIn, b);
+}
+
+// a = a \ b
+void SetDifferenceWith(Set* a, Set* b)
+{
+    // a \ a is empty, and probing a while it is cleared would miss items
+    if (a == b) {
+        SetClear(a);
+        return;
+    }
+    if (b->count < a->count) {
+        for (uint32_t i=0; i<b->capacity; i++) {
+            if (SetSlotOccupied(b, i)) SetRemove(a, (char*)b->data + i * b->itemSize);
+        }
+        return;
+    }
+    SetRetainIf(a, SetNotContainedIn, b);
 }
\ No newline at end of file
@@ -0,0 +1,321 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Memory budgeted Hashmap. Entries are partitioned by the top bits of their
+// hash into independent Hashmaps. When the resident partitions would exceed the
+// budget, the least recently used partition is written to a spill file as
+// packed [key][value] records and freed. Writes to a spilled partition are
+// appended to its file, and the partition is reloaded when it is next read.
+
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "Hashmap.h"
+
+typedef struct SpillHashmapPartition
+{
+    Hashmap hmap;
+    FILE* file;
+    uint32_t recordCount; // records in spill file (may contain overwritten keys)
+    uint32_t lastUse;
+    uint8_t resident;
+} SpillHashmapPartition;
+
+typedef struct SpillHashmap
+{
+    SpillHashmapPartition* partitions;
+    const char* spillDir;
+    size_t memoryBudget;
+    size_t memoryUsed;
+    uint32_t partitionBits;
+    uint32_t partitionCount;
+    uint32_t keySize;
+    uint32_t itemSize;
+    uint32_t tick;
+} SpillHashmap;
+
+typedef struct SpillHashmapIterator
+{
+    SpillHashmap* smap;
+    HashmapIterator inner;
+    uint32_t partition;
+} SpillHashmapIterator;
+
+static size_t SpillHashmapFootprint(uint32_t keySize, uint32_t itemSize, uint32_t capacity)
+{
+    size_t occupancyBytes = (capacity + 7) >> 3;
+    return occupancyBytes + (size_t)(keySize + itemSize) * capacity;
+}
+
+static inline uint32_t SpillHashmapPartitionOf(SpillHashmap* smap, void* key)
+{
+    if (smap->partitionBits == 0) return 0;
+    return HashGeneric(key, smap->keySize) >> (32 - smap->partitionBits);
+}
+
+// spillDir == NULL -> anonymous tmpfile() spill files
+int SpillHashmapInit(SpillHashmap* smap, uint32_t keySize, uint32_t itemSize, size_t memoryBudget, uint32_t partitionBits, const char* spillDir)
+{
+    if (partitionBits > 12) partitionBits = 12;
+    smap->partitionBits = partitionBits;
+    smap->partitionCount = 1u << partitionBits;
+    smap->partitions = (SpillHashmapPartition*)calloc(smap->partitionCount, sizeof(SpillHashmapPartition));
+    if (smap->partitions == NULL) return 0;
+    smap->spillDir = spillDir;
+    smap->memoryBudget = memoryBudget;
+    smap->memoryUsed = 0;
+    smap->keySize = keySize;
+    smap->itemSize = itemSize;
+    smap->tick = 0;
+
+    // partitions start resident and empty
+    for (uint32_t p=0; p<smap->partitionCount; p++) {
+        SpillHashmapPartition* part = &smap->partitions[p];
+        HashmapInit(&part->hmap, keySize, itemSize, 16);
+        if (part->hmap.occupancy == NULL || part->hmap.data == NULL) {
+            // unwind the partitions set up so far
+            for (uint32_t q=0; q<=p; q++) HashmapFree(&smap->partitions[q].hmap);
+            free(smap->partitions);
+            smap->partitions = NULL;
+            smap->partitionCount = 0;
+            return 0;
+        }
+        part->resident = 1;
+        smap->memoryUsed += SpillHashmapFootprint(keySize, itemSize, part->hmap.capacity);
+    }
+    return 1;
+}
+
+static FILE* SpillHashmapOpenFile(SpillHashmap* smap, uint32_t p)
+{
+    if (smap->spillDir == NULL) return tmpfile();
+
+    // named file -> unlink immediately so it is removed when closed
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/spill_%p_%u.bin", smap->spillDir, (void*)smap, p);
+    FILE* file = fopen(path, "w+b");
+    if (file) remove(path);
+    return file;
+}
+
+// write partition to its spill file and release its table
+static int SpillHashmapEvict(SpillHashmap* smap, uint32_t p)
+{
+    SpillHashmapPartition* part = &smap->partitions[p];
+    if (!part->resident) return 1;
+    if (part->file == NULL) {
+        part->file = SpillHashmapOpenFile(smap, p);
+        if (part->file == NULL) return 0;
+    }
+
+    // rewrite file with the live entries only
+    rewind(part->file);
+    uint32_t recordSize = smap->keySize + smap->itemSize;
+    Hashmap* hmap = &part->hmap;
+    for (uint32_t i=0; i<hmap->capacity; i++) {
+        if (HashmapSlotPresent(hmap, i)) {
+            char* base = (char*)hmap->data + i * recordSize;
+            if (fwrite(base, recordSize, 1, part->file) != 1) return 0;
+        }
+    }
+    fflush(part->file);
+    part->recordCount = hmap->itemCount;
+
+    smap->memoryUsed -= SpillHashmapFootprint(smap->keySize, smap->itemSize, hmap->capacity);
+    HashmapFree(hmap);
+    part->resident = 0;
+    return 1;
+}
+
+// evict least recently used partitions (other than keep) until bytes fit
+static int SpillHashmapMakeRoom(SpillHashmap* smap, size_t bytes, uint32_t keep)
+{
+    while (smap->memoryUsed + bytes > smap->memoryBudget) {
+        uint32_t victim = UINT32_MAX;
+        uint32_t oldest = UINT32_MAX;
+        for (uint32_t p=0; p<smap->partitionCount; p++) {
+            SpillHashmapPartition* part = &smap->partitions[p];
+            if (p == keep || !part->resident) continue;
+            if (part->lastUse <= oldest) {
+                oldest = part->lastUse;
+                victim = p;
+            }
+        }
+        if (victim == UINT32_MAX) return 0; // nothing left to evict
+        if (!SpillHashmapEvict(smap, victim)) return 0;
+    }
+    return 1;
+}
+
+// load spilled partition back into memory, later records win
+static int SpillHashmapReload(SpillHashmap* smap, uint32_t p)
+{
+    SpillHashmapPartition* part = &smap->partitions[p];
+    if (part->resident) return 1;
+
+    uint32_t capacity = part->recordCount * 2 + 16;
+    size_t bytes = SpillHashmapFootprint(smap->keySize, smap->itemSize, capacity);
+    SpillHashmapMakeRoom(smap, bytes, p); // over budget is allowed when unavoidable
+
+    // allocate everything before marking the partition resident
+    uint32_t recordSize = smap->keySize + smap->itemSize;
+    char* record = (char*)malloc(recordSize);
+    if (record == NULL) return 0;
+    HashmapInit(&part->hmap, smap->keySize, smap->itemSize, capacity);
+    if (part->hmap.occupancy == NULL || part->hmap.data == NULL) {
+        HashmapFree(&part->hmap);
+        free(record);
+        return 0;
+    }
+    smap->memoryUsed += SpillHashmapFootprint(smap->keySize, smap->itemSize, part->hmap.capacity);
+    part->resident = 1;
+
+    rewind(part->file);
+    for (uint32_t r=0; r<part->recordCount; r++) {
+        if (fread(record, recordSize, 1, part->file) != 1) break;
+        HashmapSet(&part->hmap, record, record + smap->keySize);
+    }
+    free(record);
+    part->recordCount = 0;
+    return 1;
+}
+
+int SpillHashmapSet(SpillHashmap* smap, void* key, void* value)
+{
+    uint32_t p = SpillHashmapPartitionOf(smap, key);
+    SpillHashmapPartition* part = &smap->partitions[p];
+    part->lastUse = ++smap->tick;
+
+    // spilled partition -> append record, resolved on reload
+    if (!part->resident) {
+        fseek(part->file, (long)part->recordCount * (smap->keySize + smap->itemSize), SEEK_SET);
+        if (fwrite(key, smap->keySize, 1, part->file) != 1) return 0;
+        if (fwrite(value, smap->itemSize, 1, part->file) != 1) return 0;
+        part->recordCount++;
+        return 1;
+    }
+
+    // this set would grow the table -> make room or spill the partition itself
+    Hashmap* hmap = &part->hmap;
+    if ((float)hmap->itemCount / (float)hmap->capacity > 0.5f) {
+        size_t grownBytes = SpillHashmapFootprint(smap->keySize, smap->itemSize, hmap->capacity * 2);
+        if (!SpillHashmapMakeRoom(smap, grownBytes, p)) {
+            if (HashmapContains(hmap, key)) {
+                memcpy(HashmapGet(hmap, key), value, smap->itemSize);
+                return 1;
+            }
+            if (!SpillHashmapEvict(smap, p)) return 0;
+            return SpillHashmapSet(smap, key, value);
+        }
+    }
+
+    uint32_t oldCapacity = hmap->capacity;
+    HashmapSet(hmap, key, value);
+    if (hmap->capacity != oldCapacity) {
+        smap->memoryUsed -= SpillHashmapFootprint(smap->keySize, smap->itemSize, oldCapacity);
+        smap->memoryUsed += SpillHashmapFootprint(smap->keySize, smap->itemSize, hmap->capacity);
+    }
+    return 1;
+}
+
+// returned pointer is valid until the next call on the map
+void* SpillHashmapGet(SpillHashmap* smap, void* key)
+{
+    uint32_t p = SpillHashmapPartitionOf(smap, key);
+    SpillHashmapPartition* part = &smap->partitions[p];
+    part->lastUse = ++smap->tick;
+    if (!part->resident && !SpillHashmapReload(smap, p)) return NULL;
+    return HashmapGet(&part->hmap, key);
+}
+
+int SpillHashmapContains(SpillHashmap* smap, void* key)
+{
+    return SpillHashmapGet(smap, key) != NULL;
+}
+
+void SpillHashmapDelete(SpillHashmap* smap, void* key)
+{
+    uint32_t p = SpillHashmapPartitionOf(smap, key);
+    SpillHashmapPartition* part = &smap->partitions[p];
+    part->lastUse = ++smap->tick;
+    if (!part->resident && !SpillHashmapReload(smap, p)) return;
+    HashmapDelete(&part->hmap, key);
+}
+
+// counts spilled records, which may include overwritten keys
+uint32_t SpillHashmapCountUpperBound(SpillHashmap* smap)
+{
+    uint32_t count = 0;
+    for (uint32_t p=0; p<smap->partitionCount; p++) {
+        SpillHashmapPartition* part = &smap->partitions[p];
+        count += part->resident ? part->hmap.itemCount : part->recordCount;
+    }
+    return count;
+}
+
+SpillHashmapIterator SpillHashmapCreateIterator(SpillHashmap* smap)
+{
+    SpillHashmapIterator iterator;
+    iterator.smap = smap;
+    iterator.partition = 0;
+    iterator.inner.hmap = NULL;
+    iterator.inner.index = 0;
+    return iterator;
+}
+
+// partitions are visited in order; spilled ones are reloaded one at a time
+int SpillHashmapIteratorNext(SpillHashmapIterator* it, void** keyOut, void** valOut)
+{
+    SpillHashmap* smap = it->smap;
+    while (it->partition < smap->partitionCount) {
+        SpillHashmapPartition* part = &smap->partitions[it->partition];
+        if (it->inner.hmap == NULL) {
+            part->lastUse = ++smap->tick;
+            if (!part->resident && !SpillHashmapReload(smap, it->partition)) return 0;
+            it->inner = HashmapCreateIterator(&part->hmap);
+        }
+        if (HashmapIteratorNext(&it->inner, keyOut, valOut)) {
+            return 1;
+        }
+        it->inner.hmap = NULL;
+        it->partition++;
+    }
+
+    // done -> reset
+    it->partition = 0;
+    return 0;
+}
+
+void SpillHashmapFree(SpillHashmap* smap)
+{
+    if (smap->partitions == NULL) return;
+    for (uint32_t p=0; p<smap->partitionCount; p++) {
+        SpillHashmapPartition* part = &smap->partitions[p];
+        if (part->resident) HashmapFree(&part->hmap);
+        if (part->file) fclose(part->file);
+    }
+    free(smap->partitions);
+    smap->partitions = NULL;
+    smap->partitionCount = 0;
+    smap->memoryUsed = 0;
+}
@@ -25,6 +25,12 @@
 #pragma once
 #include <stdint.h>
 #include <string.h>
+#include "StringHash.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 
 typedef unsigned char* String;
@@ -64,6 +70,43 @@ inline uint32_t StringLen(String string)
     return *(uint32_t*)string;
 }
 
+uint32_t StringHash(String string)
+{
+    return StringHashWide(StringCstr(string), StringLen(string));
+}
+
+// Decodes one strict UTF-8 sequence (no overlongs, surrogates or values past
+// U+10FFFF). Returns its length, or 0 if invalid. Bytes are checked in order
+// and the first bad one stops the decode, so a NUL terminator is never read past.
+static inline uint32_t StringDecodeUTF8(const uint8_t* p, uint32_t remaining, uint32_t* cp)
+{
+    uint8_t c = p[0];
+    if (c < 0x80) {
+        *cp = c;
+        return 1;
+    }
+    if (c < 0xC2 || c > 0xF4) return 0;
+
+    // allowed range of the second byte
+    uint8_t lo = 0x80, hi = 0xBF;
+    if (c == 0xE0) lo = 0xA0;
+    else if (c == 0xED) hi = 0x9F;
+    else if (c == 0xF0) lo = 0x90;
+    else if (c == 0xF4) hi = 0x8F;
+
+    uint32_t len = c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    if (remaining < 2 || p[1] < lo || p[1] > hi) return 0;
+    uint32_t value = c & (0x7F >> len);
+    value = (value << 6) | (p[1] & 0x3F);
+    for (uint32_t k=2; k<len; k++) {
+        if (remaining <= k || (p[k] & 0xC0) != 0x80) return 0;
+        value = (value << 6) | (p[k] & 0x3F);
+    }
+    *cp = value;
+    return len;
+}
+
+// invalid sequences yield U+FFFD and advance one byte
 uint32_t NextUTF8Codepoint(String string, int* i)
 {
     char* cStr = StringCstr(string);
@@ -72,38 +115,12 @@ uint32_t NextUTF8Codepoint(String string, int* i)
 
     if (*p == 0) return 0;  // end of string
 
-    if ((*p & 0x80) == 0) {
-        cp = *p++;
-    }
-    else if ((*p & 0xE0) == 0xC0 &&
-            (p[1] & 0xC0) == 0x80) {
-        cp = (*p & 0x1F) << 6 |
-            (p[1] & 0x3F);
-        p += 2;
-    }
-    else if ((*p & 0xF0) == 0xE0 &&
-            (p[1] & 0xC0) == 0x80 &&
-            (p[2] & 0xC0) == 0x80) {
-        cp = (*p & 0x0F) << 12 |
-            (p[1] & 0x3F) << 6 |
-            (p[2] & 0x3F);
-        p += 3;
-    }
-    else if ((*p & 0xF8) == 0xF0 &&
-            (p[1] & 0xC0) == 0x80 &&
-            (p[2] & 0xC0) == 0x80 &&
-            (p[3] & 0xC0) == 0x80) {
-        cp = (*p & 0x07) << 18  |
-            (p[1] & 0x3F) << 12 |
-            (p[2] & 0x3F) << 6  |
-            (p[3] & 0x3F);
-        p += 4;
-    }
-    else { // invalid byte
+    uint32_t len = StringDecodeUTF8(p, StringLen(string) - (uint32_t)*i, &cp);
+    if (len == 0) { // invalid byte
         cp = 0xFFFD;
-        p += 1;
+        len = 1;
     }
-    *i = (int)(p - (unsigned char*)cStr);
+    *i += (int)len;
     return cp;
 }
 
@@ -190,54 +207,82 @@ inline String StringCopy(String string)
     return copy;
 }
 
-int StringContains(String string, String search)
+static inline int StringCountTrailingZeros(uint32_t x)
 {
-    // validate strings and get metadata
-    if (string == NULL || search == NULL) return -1;
-    uint32_t stringLen = StringLen(string);
-    uint32_t searchLen = StringLen(search);
-    if (stringLen == 0 || searchLen == 0) {
-        return -1;
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while ((x & 1) == 0) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+// Index of the first needle in haystack or -1. Compares the needle's first and
+// last byte against a whole block of positions at once and only runs memcmp on
+// positions where both match. Allocates nothing.
+int StringFind(const char* haystack, uint32_t haystackLen, const char* needle, uint32_t needleLen)
+{
+    if (needleLen == 0 || needleLen > haystackLen) return -1;
+    if (needleLen == 1) {
+        const char* hit = (const char*)memchr(haystack, needle[0], haystackLen);
+        return hit ? (int)(hit - haystack) : -1;
     }
-    char* stringCstr = StringCstr(string);
-    char* searchCstr = StringCstr(search);
-
-    // longest prefix-suffix
-    uint16_t* lps = (uint16_t*)calloc(searchLen, sizeof(uint16_t));
-    int j = 0;
-    int i = 1;
-    while (i < searchLen) {
-        if (searchCstr[i] == searchCstr[j]) {
-            j += 1; lps[i] = j; i += 1;
+
+    uint32_t last = needleLen - 1;
+    uint32_t positions = haystackLen - needleLen + 1; // candidate starts
+    uint32_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i first32 = _mm256_set1_epi8(needle[0]);
+    const __m256i last32 = _mm256_set1_epi8(needle[last]);
+    for (; i + 32 <= positions; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(haystack + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(haystack + i + last));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first32), _mm256_cmpeq_epi8(b, last32)));
+        while (mask) {
+            uint32_t pos = i + StringCountTrailingZeros(mask);
+            if (memcmp(haystack + pos + 1, needle + 1, needleLen - 2) == 0) return (int)pos;
+            mask &= mask - 1;
         }
-        else {
-            if (j != 0) { j = lps[j - 1]; }
-            else {
-                lps[i] = 0; i += 1;
-            }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i first16 = _mm_set1_epi8(needle[0]);
+    const __m128i last16 = _mm_set1_epi8(needle[last]);
+    for (; i + 16 <= positions; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(haystack + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(haystack + i + last));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first16), _mm_cmpeq_epi8(b, last16)));
+        while (mask) {
+            uint32_t pos = i + StringCountTrailingZeros(mask);
+            if (memcmp(haystack + pos + 1, needle + 1, needleLen - 2) == 0) return (int)pos;
+            mask &= mask - 1;
         }
     }
+#endif
 
-    // knuth-morris-pratt
-    i = 0;
-    j = 0;
-    while (i < stringLen) {
-        if (stringCstr[i] == searchCstr[j]) {
-            i++; j++;
-        }
-        if (j == searchLen) {
-            free(lps);
-            return i - j;
-        }
-        else if (i < stringLen && stringCstr[i] != searchCstr[j]) {
-            if (j != 0) { j = lps[j-1]; } 
-            else { i++; }
+    // remaining positions
+    for (; i < positions; i++) {
+        if (haystack[i] == needle[0] && haystack[i + last] == needle[last] && memcmp(haystack + i + 1, needle + 1, needleLen - 2) == 0) {
+            return (int)i;
         }
     }
-    free(lps);
     return -1;
 }
 
+int StringContains(String string, String search)
+{
+    // validate strings and get metadata
+    if (string == NULL || search == NULL) return -1;
+    uint32_t stringLen = StringLen(string);
+    uint32_t searchLen = StringLen(search);
+    if (stringLen == 0 || searchLen == 0) {
+        return -1;
+    }
+    return StringFind(StringCstr(string), stringLen, StringCstr(search), searchLen);
+}
+
 String StringReplaceFirst(String string, String target, String replacement)
 {
     if (replacement == NULL) return NULL;
@@ -0,0 +1,157 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// DATA LAYOUT
+// [header: 4 bytes][data][\0][spare capacity]
+// The buffer is laid out like a String so StringBuilderFinalize can hand it
+// over without copying. Capacity doubles on growth, so building a string from
+// n pieces copies each byte O(1) times instead of once per StringConcat.
+
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "String.h"
+
+typedef struct StringBuilder
+{
+    unsigned char* buffer;
+    uint32_t len;
+    uint32_t capacity; // data bytes, excluding header and NUL
+} StringBuilder;
+
+int StringBuilderInit(StringBuilder* builder, uint32_t capacity)
+{
+    if (capacity < 16) capacity = 16;
+    builder->buffer = (unsigned char*)malloc((size_t)capacity + 4 + 1);
+    if (builder->buffer == NULL) return 0;
+    builder->len = 0;
+    builder->capacity = capacity;
+    builder->buffer[4] = '\0';
+    return 1;
+}
+
+void StringBuilderFree(StringBuilder* builder)
+{
+    free(builder->buffer);
+    builder->buffer = NULL;
+    builder->len = 0;
+    builder->capacity = 0;
+}
+
+// make room for at least additional more bytes
+int StringBuilderReserve(StringBuilder* builder, uint32_t additional)
+{
+    uint64_t needed = (uint64_t)builder->len + additional;
+    if (needed <= builder->capacity) return 1;
+    if (needed > 0xFFFFFFFFu - 5) return 0;
+    uint64_t capacity = builder->capacity ? builder->capacity : 16;
+    while (capacity < needed) capacity *= 2;
+    if (capacity > 0xFFFFFFFFu - 5) capacity = needed;
+    unsigned char* buffer = (unsigned char*)realloc(builder->buffer, (size_t)capacity + 4 + 1);
+    if (buffer == NULL) return 0;
+    builder->buffer = buffer;
+    builder->capacity = (uint32_t)capacity;
+    return 1;
+}
+
+int StringBuilderAppendN(StringBuilder* builder, const char* data, uint32_t len)
+{
+    if (!StringBuilderReserve(builder, len)) return 0;
+    memcpy(builder->buffer + 4 + builder->len, data, len);
+    builder->len += len;
+    builder->buffer[4 + builder->len] = '\0';
+    return 1;
+}
+
+int StringBuilderAppend(StringBuilder* builder, String string)
+{
+    if (string == NULL) return 0;
+    return StringBuilderAppendN(builder, StringCstr(string), StringLen(string));
+}
+
+int StringBuilderAppendCstr(StringBuilder* builder, const char* cstr)
+{
+    return StringBuilderAppendN(builder, cstr, (uint32_t)strlen(cstr));
+}
+
+int StringBuilderAppendChar(StringBuilder* builder, char c)
+{
+    return StringBuilderAppendN(builder, &c, 1);
+}
+
+int StringBuilderAppendUint(StringBuilder* builder, uint64_t value)
+{
+    // digits are produced backwards
+    char digits[20];
+    int n = 0;
+    do {
+        digits[19 - n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    return StringBuilderAppendN(builder, digits + 20 - n, (uint32_t)n);
+}
+
+int StringBuilderAppendInt(StringBuilder* builder, int64_t value)
+{
+    if (value >= 0) return StringBuilderAppendUint(builder, (uint64_t)value);
+    if (!StringBuilderAppendChar(builder, '-')) return 0;
+    return StringBuilderAppendUint(builder, 0 - (uint64_t)value);
+}
+
+// %.15g, or %.17g when needed to read back as the same double
+int StringBuilderAppendFloat(StringBuilder* builder, double value)
+{
+    char text[32];
+    int n = snprintf(text, sizeof(text), "%.15g", value);
+    if (n > 0 && n < (int)sizeof(text) && strtod(text, NULL) != value) {
+        n = snprintf(text, sizeof(text), "%.17g", value);
+    }
+    if (n < 0 || n >= (int)sizeof(text)) return 0;
+    return StringBuilderAppendN(builder, text, (uint32_t)n);
+}
+
+inline void StringBuilderClear(StringBuilder* builder)
+{
+    builder->len = 0;
+    builder->buffer[4] = '\0';
+}
+
+// NUL terminated contents; valid until the next append
+inline char* StringBuilderCstr(StringBuilder* builder)
+{
+    return (char*)builder->buffer + 4;
+}
+
+// Hands the buffer over as a String without copying and leaves the builder
+// empty; call StringBuilderInit again to reuse it.
+String StringBuilderFinalize(StringBuilder* builder)
+{
+    String result = builder->buffer;
+    if (result == NULL) return NULL;
+    memcpy(result, &builder->len, sizeof(uint32_t));
+    result[4 + builder->len] = '\0';
+    builder->buffer = NULL;
+    builder->len = 0;
+    builder->capacity = 0;
+    return result;
+}
@@ -0,0 +1,138 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// String hashes shared by the string containers.
+// STRING_HASH_FNV hashes one byte per multiply and can measure a NUL
+// terminated key while hashing it. STRING_HASH_WIDE reads 8 bytes at a time
+// (48 bytes per round on long keys) and is much faster once keys are longer
+// than a few words, e.g. paths and URLs.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#define STRING_HASH_FNV 0
+#define STRING_HASH_WIDE 1
+
+static const uint64_t StringHashSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+// 64x64 -> 128 bit multiply, low half in *a, high half in *b
+static inline void StringHashMultiply(uint64_t* a, uint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    *a = lo;
+    *b = hi;
+#endif
+}
+
+static inline uint64_t StringHashMix(uint64_t a, uint64_t b)
+{
+    StringHashMultiply(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t StringHashRead8(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t StringHashRead4(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// wyhash algorithm https://github.com/wangyi-fudan/wyhash
+uint64_t StringHashWide64(const void* key, uint64_t len, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)key;
+    const uint64_t* secret = StringHashSecret;
+    seed ^= StringHashMix(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (StringHashRead4(p) << 32) | StringHashRead4(p + ((len >> 3) << 2));
+            b = (StringHashRead4(p + len - 4) << 32) | StringHashRead4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        uint64_t i = len;
+
+        // three independent lanes of 16 bytes
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = StringHashMix(StringHashRead8(p) ^ secret[1], StringHashRead8(p + 8) ^ seed);
+                see1 = StringHashMix(StringHashRead8(p + 16) ^ secret[2], StringHashRead8(p + 24) ^ see1);
+                see2 = StringHashMix(StringHashRead8(p + 32) ^ secret[3], StringHashRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = StringHashMix(StringHashRead8(p) ^ secret[1], StringHashRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = StringHashRead8(p + i - 16);
+        b = StringHashRead8(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    StringHashMultiply(&a, &b);
+    return StringHashMix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+uint32_t StringHashWide(const void* key, uint32_t len)
+{
+    uint64_t hash = StringHashWide64(key, len, 0);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
@@ -0,0 +1,173 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Pattern compiled once and searched for in many haystacks. The strategy is
+// picked from the needle length:
+//   1 byte          -> memchr
+//   2..32 bytes     -> SIMD first/last byte filter (StringFind)
+//   longer needles  -> Boyer-Moore-Horspool with a 256 entry shift table
+// A compiled searcher is never written to by the Find functions, so one
+// searcher can be shared by any number of threads.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "String.h"
+#include "DynamicArray.h"
+
+#define STRING_SEARCHER_SIMD_MAX 32
+
+enum { STRING_SEARCH_MEMCHR = 0, STRING_SEARCH_SIMD = 1, STRING_SEARCH_HORSPOOL = 2 };
+
+typedef struct StringSearcher
+{
+    char* needle;
+    uint32_t len;
+    uint32_t strategy;
+    uint32_t shift[256]; // Horspool only
+} StringSearcher;
+
+int StringSearcherInit(StringSearcher* searcher, const char* needle, uint32_t len)
+{
+    searcher->needle = (char*)malloc(len ? len : 1);
+    if (searcher->needle == NULL) return 0;
+    memcpy(searcher->needle, needle, len);
+    searcher->len = len;
+
+    // pick strategy
+#if defined(__SSE2__)
+    uint32_t simdMax = STRING_SEARCHER_SIMD_MAX;
+#else
+    uint32_t simdMax = 3;
+#endif
+    if (len <= 1) searcher->strategy = STRING_SEARCH_MEMCHR;
+    else if (len <= simdMax) searcher->strategy = STRING_SEARCH_SIMD;
+    else searcher->strategy = STRING_SEARCH_HORSPOOL;
+
+    // bad character shifts
+    if (searcher->strategy == STRING_SEARCH_HORSPOOL) {
+        for (int c=0; c<256; c++) searcher->shift[c] = len;
+        for (uint32_t i=0; i<len-1; i++) searcher->shift[(uint8_t)needle[i]] = len - 1 - i;
+    }
+    return 1;
+}
+
+int StringSearcherInitString(StringSearcher* searcher, String needle)
+{
+    return StringSearcherInit(searcher, StringCstr(needle), StringLen(needle));
+}
+
+void StringSearcherFree(StringSearcher* searcher)
+{
+    free(searcher->needle);
+    searcher->needle = NULL;
+    searcher->len = 0;
+}
+
+static int StringSearcherHorspool(const StringSearcher* searcher, const char* haystack, uint32_t haystackLen)
+{
+    uint32_t len = searcher->len;
+    uint32_t last = len - 1;
+    uint8_t lastByte = (uint8_t)searcher->needle[last];
+    uint32_t i = 0;
+    while (i + len <= haystackLen) {
+        uint8_t c = (uint8_t)haystack[i + last];
+        if (c == lastByte && memcmp(haystack + i, searcher->needle, last) == 0) return (int)i;
+        i += searcher->shift[c];
+    }
+    return -1;
+}
+
+// index of the first match at or after start, or -1
+static int StringSearcherFindFrom(const StringSearcher* searcher, const char* haystack, uint32_t haystackLen, uint32_t start)
+{
+    if (searcher->len == 0 || start > haystackLen || haystackLen - start < searcher->len) return -1;
+    const char* from = haystack + start;
+    uint32_t fromLen = haystackLen - start;
+    int found;
+    switch (searcher->strategy) {
+        case STRING_SEARCH_MEMCHR: {
+            const char* hit = (const char*)memchr(from, searcher->needle[0], fromLen);
+            found = hit ? (int)(hit - from) : -1;
+            break;
+        }
+        case STRING_SEARCH_SIMD:
+            found = StringFind(from, fromLen, searcher->needle, searcher->len);
+            break;
+        default:
+            found = StringSearcherHorspool(searcher, from, fromLen);
+            break;
+    }
+    return found < 0 ? -1 : found + (int)start;
+}
+
+int StringSearcherFindN(const StringSearcher* searcher, const char* haystack, uint32_t haystackLen)
+{
+    return StringSearcherFindFrom(searcher, haystack, haystackLen, 0);
+}
+
+int StringSearcherFind(const StringSearcher* searcher, String haystack)
+{
+    return StringSearcherFindFrom(searcher, StringCstr(haystack), StringLen(haystack), 0);
+}
+
+int StringSearcherFindCstr(const StringSearcher* searcher, const char* haystack)
+{
+    return StringSearcherFindFrom(searcher, haystack, (uint32_t)strlen(haystack), 0);
+}
+
+// pushes the uint32_t index of every non-overlapping match into out, which
+// must be initialised with elementSize 4; returns the number of matches
+uint32_t StringSearcherFindAllN(const StringSearcher* searcher, const char* haystack, uint32_t haystackLen, DynamicArray* out)
+{
+    uint32_t count = 0;
+    int found = StringSearcherFindFrom(searcher, haystack, haystackLen, 0);
+    while (found >= 0) {
+        uint32_t index = (uint32_t)found;
+        DynamicArrayPush(out, &index);
+        count++;
+        found = StringSearcherFindFrom(searcher, haystack, haystackLen, index + searcher->len);
+    }
+    return count;
+}
+
+uint32_t StringSearcherFindAll(const StringSearcher* searcher, String haystack, DynamicArray* out)
+{
+    return StringSearcherFindAllN(searcher, StringCstr(haystack), StringLen(haystack), out);
+}
+
+// number of non-overlapping matches
+uint32_t StringSearcherCountN(const StringSearcher* searcher, const char* haystack, uint32_t haystackLen)
+{
+    uint32_t count = 0;
+    int found = StringSearcherFindFrom(searcher, haystack, haystackLen, 0);
+    while (found >= 0) {
+        count++;
+        found = StringSearcherFindFrom(searcher, haystack, haystackLen, (uint32_t)found + searcher->len);
+    }
+    return count;
+}
+
+uint32_t StringSearcherCount(const StringSearcher* searcher, String haystack)
+{
+    return StringSearcherCountN(searcher, StringCstr(haystack), StringLen(haystack));
+}
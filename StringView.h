@@ -0,0 +1,188 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Non-owning view of bytes inside a String, a C string or any buffer. Views
+// are passed by value and never allocate; they stay valid while the viewed
+// memory does. Views are not NUL terminated.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "String.h"
+
+#define STRING_TOKENIZER_MAX_SIMD 16
+
+typedef struct StringView
+{
+    const char* data;
+    uint32_t len;
+} StringView;
+
+// splits a view on delimiter bytes, yielding every field including empty ones
+typedef struct StringTokenizer
+{
+    const char* data;
+    uint32_t len;
+    uint32_t pos;
+    int done;
+    uint32_t delimCount;
+    char delims[STRING_TOKENIZER_MAX_SIMD];
+    uint32_t set[8]; // bit per delimiter byte
+} StringTokenizer;
+
+inline StringView StringViewCreate(const char* data, uint32_t len)
+{
+    StringView view;
+    view.data = data;
+    view.len = len;
+    return view;
+}
+
+inline StringView StringViewFromString(String string)
+{
+    return StringViewCreate(StringCstr(string), StringLen(string));
+}
+
+inline StringView StringViewFromCstr(const char* cstr)
+{
+    return StringViewCreate(cstr, (uint32_t)strlen(cstr));
+}
+
+// bytes [start, end) clamped to the view
+StringView StringViewSlice(StringView view, uint32_t start, uint32_t end)
+{
+    if (end > view.len) end = view.len;
+    if (start > end) start = end;
+    return StringViewCreate(view.data + start, end - start);
+}
+
+int StringViewEquals(StringView a, StringView b)
+{
+    return a.len == b.len && memcmp(a.data, b.data, a.len) == 0;
+}
+
+// <0, 0, >0 like strcmp; a shorter prefix sorts first
+int StringViewCompare(StringView a, StringView b)
+{
+    int cmp = memcmp(a.data, b.data, a.len < b.len ? a.len : b.len);
+    if (cmp != 0) return cmp;
+    return (a.len > b.len) - (a.len < b.len);
+}
+
+int StringViewStartsWith(StringView view, StringView prefix)
+{
+    return prefix.len <= view.len && memcmp(view.data, prefix.data, prefix.len) == 0;
+}
+
+int StringViewEndsWith(StringView view, StringView suffix)
+{
+    return suffix.len <= view.len && memcmp(view.data + view.len - suffix.len, suffix.data, suffix.len) == 0;
+}
+
+// index of the first needle or -1
+int StringViewFind(StringView view, StringView needle)
+{
+    return StringFind(view.data, view.len, needle.data, needle.len);
+}
+
+// same value as StringHash on a String with these bytes
+uint32_t StringViewHash(StringView view)
+{
+    return StringHashWide(view.data, view.len);
+}
+
+// copies the view into a new String
+String StringViewToString(StringView view)
+{
+    String result = (String)malloc((size_t)view.len + 4 + 1);
+    if (!result) return NULL;
+    memcpy(result, &view.len, sizeof(uint32_t));
+    memcpy(result + 4, view.data, view.len);
+    result[4 + view.len] = '\0';
+    return result;
+}
+
+// delimiters is delimiterCount bytes and may include '\0'
+StringTokenizer StringTokenizerCreateSet(StringView source, const char* delimiters, uint32_t delimiterCount)
+{
+    StringTokenizer tokenizer;
+    memset(&tokenizer, 0, sizeof(StringTokenizer));
+    tokenizer.data = source.data;
+    tokenizer.len = source.len;
+    const uint8_t* end = (const uint8_t*)delimiters + delimiterCount;
+    for (const uint8_t* d = (const uint8_t*)delimiters; d < end; d++) {
+        if (tokenizer.set[*d >> 5] & (1u << (*d & 31))) continue;
+        tokenizer.set[*d >> 5] |= 1u << (*d & 31);
+        if (tokenizer.delimCount < STRING_TOKENIZER_MAX_SIMD) tokenizer.delims[tokenizer.delimCount] = (char)*d;
+        tokenizer.delimCount++;
+    }
+    return tokenizer;
+}
+
+StringTokenizer StringTokenizerCreate(StringView source, char delimiter)
+{
+    return StringTokenizerCreateSet(source, &delimiter, 1);
+}
+
+// index of the next delimiter at or after pos, or len
+static uint32_t StringTokenizerScan(StringTokenizer* tokenizer, uint32_t pos)
+{
+    const char* data = tokenizer->data;
+    uint32_t len = tokenizer->len;
+    if (tokenizer->delimCount == 0) return len; // empty set -> one field
+    if (tokenizer->delimCount == 1) {
+        const char* hit = (const char*)memchr(data + pos, tokenizer->delims[0], len - pos);
+        return hit ? (uint32_t)(hit - data) : len;
+    }
+
+#if defined(__SSE2__)
+    // compare 16 bytes against every delimiter at once
+    if (tokenizer->delimCount <= STRING_TOKENIZER_MAX_SIMD) {
+        __m128i delims[STRING_TOKENIZER_MAX_SIMD];
+        for (uint32_t d=0; d<tokenizer->delimCount; d++) delims[d] = _mm_set1_epi8(tokenizer->delims[d]);
+        for (; pos + 16 <= len; pos += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i*)(data + pos));
+            __m128i hits = _mm_cmpeq_epi8(block, delims[0]);
+            for (uint32_t d=1; d<tokenizer->delimCount; d++) hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, delims[d]));
+            uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+            if (mask) return pos + StringCountTrailingZeros(mask);
+        }
+    }
+#endif
+
+    for (; pos < len; pos++) {
+        uint8_t c = (uint8_t)data[pos];
+        if (tokenizer->set[c >> 5] & (1u << (c & 31))) return pos;
+    }
+    return len;
+}
+
+// yields the next field; returns 0 once every field has been returned
+int StringTokenizerNext(StringTokenizer* tokenizer, StringView* out)
+{
+    if (tokenizer->done) return 0;
+    uint32_t end = StringTokenizerScan(tokenizer, tokenizer->pos);
+    *out = StringViewCreate(tokenizer->data + tokenizer->pos, end - tokenizer->pos);
+    if (end == tokenizer->len) tokenizer->done = 1;
+    else tokenizer->pos = end + 1;
+    return 1;
+}
@@ -2,6 +2,14 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include "StringHash.h"
+
+// SLOT LAYOUT
+// [StringmapKey: key bytes or key pointer, hash, length][value][padding to 8 bytes]
+// Keys shorter than STRINGMAP_INLINE_KEY bytes are stored NUL terminated inside
+// the slot; longer keys are malloc'd and the slot holds the pointer.
+
+#define STRINGMAP_INLINE_KEY 16
 
 typedef struct Stringmap
 {
@@ -11,17 +19,60 @@ typedef struct Stringmap
     uint32_t itemSize;
     uint32_t itemCount;
     uint32_t maxProbes;
+    uint32_t hashKind; // STRING_HASH_FNV or STRING_HASH_WIDE
 } Stringmap;
 
+typedef struct StringmapKey
+{
+    union {
+        char* ptr;                       // len >= STRINGMAP_INLINE_KEY
+        char inl[STRINGMAP_INLINE_KEY]; // len < STRINGMAP_INLINE_KEY
+    };
+    uint32_t hash;
+    uint32_t len;
+} StringmapKey;
+
 typedef struct StringmapIterator
 {
     Stringmap* map;
     uint32_t index;
 } StringmapIterator;
 
+static inline uint32_t StringmapSlotSize(uint32_t itemSize)
+{
+    return (uint32_t)((sizeof(StringmapKey) + itemSize + 7) & ~(size_t)7);
+}
+
+static inline StringmapKey* StringmapSlot(Stringmap* map, uint32_t i)
+{
+    return (StringmapKey*)((char*)map->map + (size_t)i * StringmapSlotSize(map->itemSize));
+}
+
+static inline void* StringmapSlotValue(StringmapKey* slot)
+{
+    return (char*)slot + sizeof(StringmapKey);
+}
+
+static inline char* StringmapSlotKey(StringmapKey* slot)
+{
+    return slot->len < STRINGMAP_INLINE_KEY ? slot->inl : slot->ptr;
+}
+
+static inline void StringmapSlotFreeKey(StringmapKey* slot)
+{
+    if (slot->len >= STRINGMAP_INLINE_KEY) free(slot->ptr);
+}
+
 void StringmapFree(Stringmap* map)
 {
     if (!map) return;
+
+    // free long keys
+    if (map->occupancy && map->map) {
+        for (uint32_t i=0; i<map->capacity; i++) {
+            if (map->occupancy[i >> 3] & (1u << (i & 7))) StringmapSlotFreeKey(StringmapSlot(map, i));
+        }
+    }
     if (map->occupancy) free(map->occupancy);
     if (map->map) free(map->map);
     map->occupancy = NULL;
@@ -39,19 +90,28 @@ int StringmapInit(Stringmap* map, uint32_t itemSize, uint32_t capacity)
     uint32_t occupancyRemainder = map->capacity & 7;
     uint32_t occupancyBytes = map->capacity >> 3;
     occupancyBytes += 1 * (occupancyRemainder != 0);
-    map->occupancy = (uint8_t*)calloc(occupancyBytes, 1); 
+    map->occupancy = (uint8_t*)calloc(occupancyBytes, 1);
     if (map->occupancy == NULL) {
         StringmapFree(map); return 0;
     }
-    map->map = malloc((sizeof(char*) + itemSize) * capacity);
+    map->map = malloc((size_t)StringmapSlotSize(itemSize) * capacity);
     map->itemSize = itemSize;
     map->itemCount = 0;
     map->maxProbes = 1;
+    map->hashKind = STRING_HASH_FNV;
 
     // success
     return 1;
 }
 
+// hashKind selects the key hash, see StringHash.h
+int StringmapInitHash(Stringmap* map, uint32_t itemSize, uint32_t capacity, uint32_t hashKind)
+{
+    if (!StringmapInit(map, itemSize, capacity)) return 0;
+    map->hashKind = hashKind;
+    return 1;
+}
+
 uint32_t StringmapHash(char* string) {
     uint32_t hash = 2166136261u;
     for (uint8_t* p = (uint8_t*)string; *p; p++) {
@@ -61,6 +121,43 @@ uint32_t StringmapHash(char* string) {
     return hash;
 }
 
+uint32_t StringmapHashN(const char* key, uint32_t len) {
+    uint32_t hash = 2166136261u;
+    const uint8_t* p = (const uint8_t*)key;
+    for (uint32_t i=0; i<len; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// hash and measure the key in one pass
+static inline uint32_t StringmapHashLen(char* string, uint32_t* lenOut) {
+    uint32_t hash = 2166136261u;
+    uint8_t* p = (uint8_t*)string;
+    for (; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    *lenOut = (uint32_t)(p - (uint8_t*)string);
+    return hash;
+}
+
+static inline uint32_t StringmapKeyHash(Stringmap* map, const char* key, uint32_t len)
+{
+    if (map->hashKind == STRING_HASH_WIDE) return StringHashWide(key, len);
+    return StringmapHashN(key, len);
+}
+
+static inline uint32_t StringmapKeyHashLen(Stringmap* map, char* key, uint32_t* lenOut)
+{
+    if (map->hashKind == STRING_HASH_WIDE) {
+        *lenOut = (uint32_t)strlen(key);
+        return StringHashWide(key, *lenOut);
+    }
+    return StringmapHashLen(key, lenOut);
+}
+
 static inline uint8_t StringmapSlotPresent(Stringmap* map, uint32_t i)
 {
     return map->occupancy[i >> 3] & (1u << (i & 7));
@@ -76,11 +173,18 @@ static inline void StringmapClearSlot(Stringmap* map, uint32_t i)
     map->occupancy[i >> 3] &= ~(1u << (i & 7));
 }
 
+// hash and length reject almost every mismatch before the key is touched
+static inline int StringmapSlotMatches(StringmapKey* slot, const char* key, uint32_t len, uint32_t hash)
+{
+    return slot->hash == hash && slot->len == len && memcmp(StringmapSlotKey(slot), key, len) == 0;
+}
+
 int StringmapGrowRehash(Stringmap* map)
 {
     uint32_t oldMapCapacity = map->capacity;
     uint8_t* oldOccupancy = map->occupancy;
     void* oldMap = map->map;
+    uint32_t slotSize = StringmapSlotSize(map->itemSize);
 
     // reisze
     map->capacity *= 2;
@@ -93,7 +197,7 @@ int StringmapGrowRehash(Stringmap* map)
         map->occupancy = oldOccupancy;
         return 0;
     }
-    map->map = malloc((sizeof(char*) + map->itemSize) * map->capacity);
+    map->map = malloc((size_t)slotSize * map->capacity);
     if (map->map == NULL) {
         free(map->occupancy);
         map->capacity = oldMapCapacity;
@@ -102,24 +206,19 @@ int StringmapGrowRehash(Stringmap* map)
         return 0;
     }
     map->maxProbes = 1;
-    
-    // re-insert items
+
+    // re-insert items, the stored hash makes this pure data movement
     for (uint32_t j=0; j<oldMapCapacity; j++) {
         if (oldOccupancy[j >> 3] & (1u << (j & 7)))
         {
-            char* oldBase = (char*)oldMap + j * (sizeof(char*) + map->itemSize);
-            char* key  = *(char**)oldBase;
-            void* value = oldBase + sizeof(char*);
+            StringmapKey* oldSlot = (StringmapKey*)((char*)oldMap + (size_t)j * slotSize);
 
             // add item
             uint32_t probes = 0;
-            uint32_t hash = StringmapHash(key);
             while(probes < map->capacity) {
-                uint32_t i = (hash + probes) % map->capacity;
+                uint32_t i = (oldSlot->hash + probes) % map->capacity;
                 if (!StringmapSlotPresent(map, i)) {
-                    char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-                    memcpy(base, &key, sizeof(char*));
-                    memcpy(base + sizeof(char*), value, map->itemSize);
+                    memcpy(StringmapSlot(map, i), oldSlot, slotSize);
                     StringmapMarkSlot(map, i);
                     break;
                 }
@@ -128,10 +227,13 @@ int StringmapGrowRehash(Stringmap* map)
             if (probes + 1 > map->maxProbes) map->maxProbes = probes + 1;
         }
     }
+
+    free(oldOccupancy);
+    free(oldMap);
     return 1;
 }
 
-void* StringmapSet(Stringmap* map, char* key, void* value)
+static void* StringmapSetHashed(Stringmap* map, const char* key, uint32_t len, uint32_t hash, void* value)
 {
     char* stored = NULL;
 
@@ -143,33 +245,35 @@ void* StringmapSet(Stringmap* map, char* key, void* value)
     }
 
     uint32_t probes = 0;
-    uint32_t hash = StringmapHash(key);
     while(probes < map->capacity) {
         uint32_t i = (hash + probes) % map->capacity;
+        StringmapKey* slot = StringmapSlot(map, i);
 
         // if key exists -> update value
         if (StringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
-                memcpy(base + sizeof(char*), value, map->itemSize);
-                stored = (char*)base + sizeof(char*);
+            if (StringmapSlotMatches(slot, key, len, hash)) {
+                memcpy(StringmapSlotValue(slot), value, map->itemSize);
+                stored = (char*)StringmapSlotValue(slot);
                 return stored;
             }
         }
         else
         {
-            StringmapMarkSlot(map, i);
-            uint32_t len = strlen(key);
-            char* storedKey = (char*)malloc(len + 1);
+            // short key -> copy into the slot, long key -> own allocation
+            char* storedKey = slot->inl;
+            if (len >= STRINGMAP_INLINE_KEY) {
+                storedKey = (char*)malloc(len + 1);
+                if (storedKey == NULL) return stored;
+                slot->ptr = storedKey;
+            }
             memcpy(storedKey, key, len); storedKey[len] = '\0';
-            if (storedKey == NULL) return stored;
 
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            memcpy(base, &storedKey, sizeof(char*));
-            memcpy(base + sizeof(char*), value, map->itemSize);
+            StringmapMarkSlot(map, i);
+            slot->hash = hash;
+            slot->len = len;
+            memcpy(StringmapSlotValue(slot), value, map->itemSize);
             map->itemCount++;
-            stored = (char*)base + sizeof(char*);
+            stored = (char*)StringmapSlotValue(slot);
             break;
         }
         probes++;
@@ -178,73 +282,113 @@ void* StringmapSet(Stringmap* map, char* key, void* value)
     return stored;
 }
 
-void* StringmapGet(Stringmap* map, char* key)
+void* StringmapSet(Stringmap* map, char* key, void* value)
+{
+    uint32_t len;
+    uint32_t hash = StringmapKeyHashLen(map, key, &len);
+    return StringmapSetHashed(map, key, len, hash, value);
+}
+
+// key is len bytes, no NUL terminator needed; it may contain NUL bytes
+void* StringmapSetN(Stringmap* map, const char* key, uint32_t len, void* value)
+{
+    return StringmapSetHashed(map, key, len, StringmapKeyHash(map, key, len), value);
+}
+
+// *String variants take a String from String.h (uint32 length, then the bytes)
+// read here directly so this header does not depend on String.h
+static inline uint32_t StringmapStringLen(const unsigned char* str)
+{
+    uint32_t len;
+    memcpy(&len, str, 4);
+    return len;
+}
+
+static inline const char* StringmapStringData(const unsigned char* str)
+{
+    return (const char*)str + 4;
+}
+
+void* StringmapSetString(Stringmap* map, const unsigned char* key, void* value)
+{
+    return StringmapSetN(map, StringmapStringData(key), StringmapStringLen(key), value);
+}
+
+static void* StringmapGetHashed(Stringmap* map, const char* key, uint32_t len, uint32_t hash)
 {
     uint32_t probes = 0;
-    uint32_t hash = StringmapHash(key);
-    while(probes < map->capacity) {
+    while(probes < map->maxProbes) {
         uint32_t i = (hash + probes) % map->capacity;
-        if (StringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
-                return (char*)base + sizeof(char*);
-            }
+        if (!StringmapSlotPresent(map, i)) return NULL;
+        StringmapKey* slot = StringmapSlot(map, i);
+        if (StringmapSlotMatches(slot, key, len, hash)) {
+            return StringmapSlotValue(slot);
         }
         probes++;
     }
     return NULL;
 }
 
+void* StringmapGet(Stringmap* map, char* key)
+{
+    uint32_t len;
+    uint32_t hash = StringmapKeyHashLen(map, key, &len);
+    return StringmapGetHashed(map, key, len, hash);
+}
+
+void* StringmapGetN(Stringmap* map, const char* key, uint32_t len)
+{
+    return StringmapGetHashed(map, key, len, StringmapKeyHash(map, key, len));
+}
+
+void* StringmapGetString(Stringmap* map, const unsigned char* key)
+{
+    return StringmapGetN(map, StringmapStringData(key), StringmapStringLen(key));
+}
+
 int StringmapContains(Stringmap* map, char* key)
 {
-    uint32_t probes = 0;
-    uint32_t hash = StringmapHash(key);
-    while(probes < map->maxProbes) {
-        uint32_t i = (hash + probes) % map->capacity;
-        if (StringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
-                return 1;
-            }
-        }
-        probes++;
-    }
-    return 0;
+    return StringmapGet(map, key) != NULL;
 }
 
-void StringmapDelete(Stringmap* map, char* key)
+int StringmapContainsN(Stringmap* map, const char* key, uint32_t len)
+{
+    return StringmapGetN(map, key, len) != NULL;
+}
+
+int StringmapContainsString(Stringmap* map, const unsigned char* key)
+{
+    return StringmapGetN(map, StringmapStringData(key), StringmapStringLen(key)) != NULL;
+}
+
+static void StringmapDeleteHashed(Stringmap* map, const char* key, uint32_t len, uint32_t hash)
 {
     uint32_t probes = 0;
-    uint32_t hash = StringmapHash(key);
+    uint32_t slotSize = StringmapSlotSize(map->itemSize);
 
     int holeIndex = -1;
-    while(probes < map->capacity) {
+    while(probes < map->maxProbes) {
         uint32_t i = (hash + probes) % map->capacity;
         if (StringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            if (strcmp(key, storedKey) == 0) {
+            StringmapKey* slot = StringmapSlot(map, i);
+            if (StringmapSlotMatches(slot, key, len, hash)) {
                 holeIndex = (int)i;
                 StringmapClearSlot(map, i);
-                free(storedKey);
+                StringmapSlotFreeKey(slot);
                 break;
             }
         }
         else break;
         probes++;
     }
-    
+
     if (holeIndex == -1) return; // key not found
 
     uint32_t i = (holeIndex + 1) % map->capacity;
     while (StringmapSlotPresent(map, i))
     {
-        char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-        char* candidateKey = *(char**)base;
-        uint32_t candidateHash = StringmapHash(candidateKey);
-        uint32_t candidateHome = candidateHash % map->capacity;
+        StringmapKey* candidate = StringmapSlot(map, i);
+        uint32_t candidateHome = candidate->hash % map->capacity;
 
         // can the candidate move into the hole?
         int canMoveCandidate;
@@ -259,11 +403,7 @@ void StringmapDelete(Stringmap* map, char* key)
         }
 
         // move candidate into the hole
-        memcpy(
-            (char*)map->map + holeIndex * (sizeof(char*) + map->itemSize),
-            base,
-            sizeof(char*) + map->itemSize
-        );
+        memcpy(StringmapSlot(map, holeIndex), candidate, slotSize);
 
         StringmapClearSlot(map, i);
         StringmapMarkSlot(map, holeIndex);
@@ -273,7 +413,65 @@ void StringmapDelete(Stringmap* map, char* key)
     }
 
     map->itemCount--;
+}
 
+void StringmapDelete(Stringmap* map, char* key)
+{
+    uint32_t len;
+    uint32_t hash = StringmapKeyHashLen(map, key, &len);
+    StringmapDeleteHashed(map, key, len, hash);
+}
+
+void StringmapDeleteN(Stringmap* map, const char* key, uint32_t len)
+{
+    StringmapDeleteHashed(map, key, len, StringmapKeyHash(map, key, len));
+}
+
+void StringmapDeleteString(Stringmap* map, const unsigned char* key)
+{
+    StringmapDeleteN(map, StringmapStringData(key), StringmapStringLen(key));
+}
+
+// Removes (and frees the key of) every entry for which keep() returns 0 in
+// one pass, re-seating kept entries behind each removal.
+uint32_t StringmapRetainIf(Stringmap* map, int (*keep)(char* key, void* value, void* userData), void* userData)
+{
+    if (map->itemCount == 0) return 0;
+    uint32_t slotSize = StringmapSlotSize(map->itemSize);
+
+    // start at an empty slot so no probe chain wraps past the scan start
+    uint32_t start = 0;
+    while (start < map->capacity && StringmapSlotPresent(map, start)) start++;
+
+    uint32_t removed = 0;
+    int holeInRun = 0;
+    for (uint32_t n=1; n<=map->capacity; n++) {
+        uint32_t i = (start + n) % map->capacity;
+        if (!StringmapSlotPresent(map, i)) { // end of probe run
+            holeInRun = 0;
+            continue;
+        }
+
+        StringmapKey* slot = StringmapSlot(map, i);
+        if (!keep(StringmapSlotKey(slot), StringmapSlotValue(slot), userData)) {
+            StringmapClearSlot(map, i);
+            StringmapSlotFreeKey(slot);
+            removed++;
+            holeInRun = 1;
+            continue;
+        }
+        if (!holeInRun) continue;
+
+        // move entry to the first free slot from its home
+        StringmapClearSlot(map, i);
+        uint32_t j = slot->hash % map->capacity;
+        while (StringmapSlotPresent(map, j)) j = (j + 1) % map->capacity;
+        if (j != i) memcpy(StringmapSlot(map, j), slot, slotSize);
+        StringmapMarkSlot(map, j);
+    }
+
+    map->itemCount -= removed;
+    return removed;
 }
 
 void StringmapClear(Stringmap* map)
@@ -281,19 +479,17 @@ void StringmapClear(Stringmap* map)
     if (!map || map->itemCount == 0)
         return;
 
-    // Free all allocated keys
+    // Free long keys, short keys live in the slots
     for (uint32_t i = 0; i < map->capacity; i++) {
         if (StringmapSlotPresent(map, i)) {
-            char* base = (char*)map->map + i * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
-            free(storedKey);
+            StringmapSlotFreeKey(StringmapSlot(map, i));
         }
     }
 
     // Reset occupancy bits
     uint32_t occupancyBytes = (map->capacity + 7) >> 3;
     memset(map->occupancy, 0, occupancyBytes);
-    memset(map->map, 0, (sizeof(char*) + map->itemSize) * map->capacity);
+    memset(map->map, 0, (size_t)StringmapSlotSize(map->itemSize) * map->capacity);
     map->itemCount = 0;
     map->maxProbes = 1;
 }
@@ -308,7 +504,9 @@ StringmapIterator StringmapCreateIterator(Stringmap* map)
     return iterator;
 }
 
-int StringmapIteratorNext(StringmapIterator* it, char** keyOut, void** valOut)
+// short keys point into the table and are valid until the map is modified
+// lenOut is the stored length, keys set with the *N variants may contain NUL
+int StringmapIteratorNextN(StringmapIterator* it, char** keyOut, uint32_t* lenOut, void** valOut)
 {
     Stringmap* map = it->map;
 
@@ -319,13 +517,13 @@ int StringmapIteratorNext(StringmapIterator* it, char** keyOut, void** valOut)
 
     while (it->index < map->capacity) {
 
-        // found item -> set key, value
+        // found item -> set key, length, value
         if (StringmapSlotPresent(map, it->index)) {
-            char* base = (char*)map->map + it->index * (sizeof(char*) + map->itemSize);
-            char* storedKey = *(char**)base;
+            StringmapKey* slot = StringmapSlot(map, it->index);
             it->index++;
-            *keyOut = storedKey;
-            *valOut = (char*)base + sizeof(char*);
+            *keyOut = StringmapSlotKey(slot);
+            *lenOut = slot->len;
+            *valOut = StringmapSlotValue(slot);
             return 1;
         }
         it->index++;
@@ -335,3 +533,9 @@ int StringmapIteratorNext(StringmapIterator* it, char** keyOut, void** valOut)
     it->index = 0;
     return 0;
 }
+
+int StringmapIteratorNext(StringmapIterator* it, char** keyOut, void** valOut)
+{
+    uint32_t len;
+    return StringmapIteratorNextN(it, keyOut, &len, valOut);
+}
@@ -0,0 +1,156 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Interns strings to dense sequential uint32_t ids (0, 1, 2, ...).
+// Keys live in the LinearStringmap chunk arena, which never moves them, so
+// id -> string is a single array load. Other containers can then be keyed by
+// the 4 byte id instead of a char*.
+
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LinearStringmap.h"
+#include "String.h"
+
+#define SYMBOL_NONE 0xFFFFFFFFu
+
+typedef struct SymbolTable
+{
+    LinearStringmap map; // key -> id
+    char** strings;      // id -> key in the map arena
+    uint32_t* lengths;   // id -> key length
+    uint32_t count;
+    uint32_t capacity;
+} SymbolTable;
+
+void SymbolTableFree(SymbolTable* table)
+{
+    if (!table) return;
+    LinearStringmapFree(&table->map);
+    free(table->strings);
+    free(table->lengths);
+    table->strings = NULL;
+    table->lengths = NULL;
+    table->count = 0;
+    table->capacity = 0;
+}
+
+int SymbolTableInit(SymbolTable* table, uint32_t capacity, uint32_t chunkCapacity)
+{
+    if (capacity < 16) capacity = 16;
+    table->strings = (char**)malloc(sizeof(char*) * capacity);
+    table->lengths = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+    table->count = 0;
+    table->capacity = capacity;
+    if (table->strings == NULL || table->lengths == NULL) {
+        free(table->strings);
+        free(table->lengths);
+        table->strings = NULL;
+        table->lengths = NULL;
+        return 0;
+    }
+
+    // size map so capacity symbols fit under the load factor
+    if (!LinearStringmapInit(&table->map, sizeof(uint32_t), capacity + capacity / 2, chunkCapacity)) {
+        SymbolTableFree(table);
+        return 0;
+    }
+    return 1;
+}
+
+static int SymbolTableGrow(SymbolTable* table)
+{
+    uint32_t capacity = table->capacity * 2;
+    char** strings = (char**)realloc(table->strings, sizeof(char*) * capacity);
+    if (strings == NULL) return 0;
+    table->strings = strings;
+    uint32_t* lengths = (uint32_t*)realloc(table->lengths, sizeof(uint32_t) * capacity);
+    if (lengths == NULL) return 0;
+    table->lengths = lengths;
+    table->capacity = capacity;
+    return 1;
+}
+
+// key is len bytes without NUL terminator; keys may not contain NUL bytes
+// returns SYMBOL_NONE if out of memory
+uint32_t SymbolTableInternN(SymbolTable* table, const char* key, uint32_t len)
+{
+    uint32_t hash = LinearStringmapKeyHash(&table->map, key, len);
+    uint32_t* found = (uint32_t*)LinearStringmapGetHashed(&table->map, key, len, hash);
+    if (found) return *found;
+
+    if (table->count == SYMBOL_NONE) return SYMBOL_NONE;
+    if (table->count == table->capacity && !SymbolTableGrow(table)) return SYMBOL_NONE;
+
+    // add new symbol
+    uint32_t id = table->count;
+    if (!LinearStringmapSetHashed(&table->map, key, len, hash, &id)) return SYMBOL_NONE;
+    void* value = LinearStringmapGetHashed(&table->map, key, len, hash);
+    table->strings[id] = LinearStringmapValueKey(value);
+    table->lengths[id] = len;
+    table->count++;
+    return id;
+}
+
+uint32_t SymbolTableIntern(SymbolTable* table, char* key)
+{
+    return SymbolTableInternN(table, key, (uint32_t)strlen(key));
+}
+
+uint32_t SymbolTableInternString(SymbolTable* table, String key)
+{
+    return SymbolTableInternN(table, StringCstr(key), StringLen(key));
+}
+
+// id of an already interned key, or SYMBOL_NONE
+uint32_t SymbolTableLookupN(SymbolTable* table, const char* key, uint32_t len)
+{
+    uint32_t* found = (uint32_t*)LinearStringmapGetN(&table->map, key, len);
+    return found ? *found : SYMBOL_NONE;
+}
+
+uint32_t SymbolTableLookup(SymbolTable* table, char* key)
+{
+    uint32_t* found = (uint32_t*)LinearStringmapGet(&table->map, key);
+    return found ? *found : SYMBOL_NONE;
+}
+
+uint32_t SymbolTableLookupString(SymbolTable* table, String key)
+{
+    return SymbolTableLookupN(table, StringCstr(key), StringLen(key));
+}
+
+// NUL terminated key for id; valid until SymbolTableFree
+inline char* SymbolTableString(SymbolTable* table, uint32_t id)
+{
+    return table->strings[id];
+}
+
+inline uint32_t SymbolTableLen(SymbolTable* table, uint32_t id)
+{
+    return table->lengths[id];
+}
+
+inline uint32_t SymbolTableCount(SymbolTable* table)
+{
+    return table->count;
+}
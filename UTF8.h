@@ -0,0 +1,258 @@
+// MIT License
+// Copyright (c) 2026 Arran Stevens
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Bulk UTF-8 validation and UTF-8 <-> UTF-32 transcoding.
+// With SSSE3 validation checks 16 bytes per step whatever the mix of ASCII
+// and multibyte text (lookup tables over byte nibbles, Keiser & Lemire 2020).
+// Otherwise, and for transcoding, runs of ASCII are handled 16 bytes per step
+// with SSE2 (32 with AVX2 for validation) and everything else goes through the
+// strict StringDecodeUTF8 one codepoint at a time, which is several times
+// slower on mostly non-ASCII text.
+// Output buffers are supplied by the caller: UTF-32 output needs at most one
+// codepoint per input byte and UTF-8 output at most 4 bytes per codepoint.
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "String.h"
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#if defined(__SSSE3__)
+// error bits, set when a pair of adjacent bytes matches the pattern
+#define UTF8_TOO_SHORT  (1 << 0) // 11______ 0_______ or 11______ 11______
+#define UTF8_TOO_LONG   (1 << 1) // 0_______ 10______
+#define UTF8_OVERLONG_3 (1 << 2) // 11100000 100_____
+#define UTF8_TOO_LARGE  (1 << 3) // 11110100 1001____ and above
+#define UTF8_SURROGATE  (1 << 4) // 11101101 101_____
+#define UTF8_OVERLONG_2 (1 << 5) // 1100000_ 10______
+#define UTF8_TOO_LARGE_1000 (1 << 6) // 11110101 1000____ and above
+#define UTF8_OVERLONG_4 (1 << 6) // 11110000 1000____
+#define UTF8_TWO_CONTS  (1 << 7) // 10______ 10______ (valid only inside a 3/4 byte sequence)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+// nonzero bytes where block (following prev) is not valid UTF-8, ignoring a
+// sequence cut off at the end of block
+static inline __m128i UTF8CheckBlock(__m128i block, __m128i prev)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i byte1HighTable = _mm_setr_epi8(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4);
+    const __m128i byte1LowTable = _mm_setr_epi8(
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,
+        UTF8_CARRY | UTF8_OVERLONG_2,
+        UTF8_CARRY,
+        UTF8_CARRY,
+        UTF8_CARRY | UTF8_TOO_LARGE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+        UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000);
+    const __m128i byte2HighTable = _mm_setr_epi8(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+
+    // classify each byte together with the one before it
+    __m128i prev1 = _mm_alignr_epi8(block, prev, 15);
+    __m128i byte1High = _mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(prev1, nibble));
+    __m128i byte2High = _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+    __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // two continuations in a row are only valid 2 or 3 bytes after a 3/4 byte lead
+    __m128i prev2 = _mm_alignr_epi8(block, prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(block, prev, 13);
+    __m128i isThird = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+    __m128i isFourth = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+    __m128i must23 = _mm_and_si128(_mm_or_si128(isThird, isFourth), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must23, special);
+}
+#endif
+
+// 1 if data is valid UTF-8
+int UTF8Validate(const char* data, uint32_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t i = 0;
+
+#if defined(__SSSE3__)
+    // whole blocks, then finish from the start of the last sequence they cut into
+    if (len >= 16) {
+        __m128i prev = _mm_setzero_si128();
+        __m128i error = _mm_setzero_si128();
+        for (; i + 16 <= len; i += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i*)(p + i));
+            error = _mm_or_si128(error, UTF8CheckBlock(block, prev));
+            prev = block;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF) return 0;
+        uint32_t back = 0;
+        while (back < 3 && (p[i - back - 1] & 0xC0) == 0x80) back++;
+        if (p[i - back - 1] >= 0xC0) i -= back + 1;
+    }
+#endif
+
+    while (i < len) {
+
+        // skip ASCII blocks
+#if defined(__AVX2__)
+        while (i + 32 <= len && _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)(p + i))) == 0) i += 32;
+#endif
+#if defined(__SSE2__)
+        while (i + 16 <= len && _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(p + i))) == 0) i += 16;
+#endif
+        if (i >= len) break;
+        if (p[i] < 0x80) {
+            i++;
+            continue;
+        }
+
+        uint32_t cp;
+        uint32_t step = StringDecodeUTF8(p + i, len - i, &cp);
+        if (step == 0) return 0;
+        i += step;
+    }
+    return 1;
+}
+
+int StringValidateUTF8(String string)
+{
+    return UTF8Validate(StringCstr(string), StringLen(string));
+}
+
+// Decodes src into dst. Returns 1 and the codepoint count in dstLenOut, or 0
+// if src is not valid UTF-8 or dst is too small.
+int UTF8ToUTF32(const char* src, uint32_t srcLen, uint32_t* dst, uint32_t dstCapacity, uint32_t* dstLenOut)
+{
+    const uint8_t* p = (const uint8_t*)src;
+    uint32_t i = 0;
+    uint32_t out = 0;
+    while (i < srcLen) {
+
+        // widen 16 ASCII bytes to 16 codepoints
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= srcLen && out + 16 <= dstCapacity) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(p + i));
+            if (_mm_movemask_epi8(bytes) != 0) break;
+            __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            _mm_storeu_si128((__m128i*)(dst + out), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(dst + out + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i*)(dst + out + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i*)(dst + out + 12), _mm_unpackhi_epi16(hi, zero));
+            i += 16;
+            out += 16;
+        }
+        if (i >= srcLen) break;
+#endif
+        if (out >= dstCapacity) return 0;
+        uint32_t cp;
+        uint32_t step = StringDecodeUTF8(p + i, srcLen - i, &cp);
+        if (step == 0) return 0;
+        dst[out++] = cp;
+        i += step;
+    }
+    *dstLenOut = out;
+    return 1;
+}
+
+int StringToUTF32(String string, uint32_t* dst, uint32_t dstCapacity, uint32_t* dstLenOut)
+{
+    return UTF8ToUTF32(StringCstr(string), StringLen(string), dst, dstCapacity, dstLenOut);
+}
+
+// Encodes src into dst. Returns 1 and the byte count in dstLenOut, or 0 if a
+// codepoint is a surrogate or past U+10FFFF, or dst is too small.
+int UTF32ToUTF8(const uint32_t* src, uint32_t srcLen, char* dst, uint32_t dstCapacity, uint32_t* dstLenOut)
+{
+    uint8_t* q = (uint8_t*)dst;
+    uint32_t i = 0;
+    uint32_t out = 0;
+    while (i < srcLen) {
+
+        // narrow 16 ASCII codepoints to 16 bytes
+#if defined(__SSE2__)
+        const __m128i high = _mm_set1_epi32(~0x7F);
+        while (i + 16 <= srcLen && out + 16 <= dstCapacity) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 4));
+            __m128i c = _mm_loadu_si128((const __m128i*)(src + i + 8));
+            __m128i d = _mm_loadu_si128((const __m128i*)(src + i + 12));
+            __m128i any = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), high);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(any, _mm_setzero_si128())) != 0xFFFF) break;
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+            _mm_storeu_si128((__m128i*)(q + out), packed);
+            i += 16;
+            out += 16;
+        }
+        if (i >= srcLen) break;
+#endif
+        uint32_t cp = src[i++];
+        if (cp < 0x80) {
+            if (out + 1 > dstCapacity) return 0;
+            q[out++] = (uint8_t)cp;
+        }
+        else if (cp < 0x800) {
+            if (out + 2 > dstCapacity) return 0;
+            q[out++] = (uint8_t)(0xC0 | (cp >> 6));
+            q[out++] = (uint8_t)(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000) {
+            if (cp >= 0xD800 && cp <= 0xDFFF) return 0;
+            if (out + 3 > dstCapacity) return 0;
+            q[out++] = (uint8_t)(0xE0 | (cp >> 12));
+            q[out++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+            q[out++] = (uint8_t)(0x80 | (cp & 0x3F));
+        }
+        else if (cp <= 0x10FFFF) {
+            if (out + 4 > dstCapacity) return 0;
+            q[out++] = (uint8_t)(0xF0 | (cp >> 18));
+            q[out++] = (uint8_t)(0x80 | ((cp >> 12) & 0x3F));
+            q[out++] = (uint8_t)(0x80 | ((cp >> 6) & 0x3F));
+            q[out++] = (uint8_t)(0x80 | (cp & 0x3F));
+        }
+        else {
+            return 0;
+        }
+    }
+    *dstLenOut = out;
+    return 1;
+}